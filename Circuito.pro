@@ -6,6 +6,8 @@
 
 QT       += core gui
 
+CONFIG   += thread
+
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TARGET = Circuito
@@ -31,7 +33,16 @@ SOURCES += main.cpp\
     newcircuito.cpp \
     modificarsaida.cpp \
     bool3S.cpp \
-    porta.cpp
+    porta.cpp \
+    arenaportas.cpp \
+    circuitocompilado.cpp \
+    kernelsimd.cpp \
+    tabelaverdade.cpp \
+    otimizar.cpp \
+    arquivomapeado.cpp \
+    importar.cpp \
+    exportartabela.cpp \
+    pooltrabalho.cpp
 
 HEADERS  += maincircuito.h \
     circuito.h \
@@ -40,7 +51,19 @@ HEADERS  += maincircuito.h \
     newcircuito.h \
     modificarsaida.h \
     bool3S.h \
-    porta.h
+    bool3S64.h \
+    dominiovalor.h \
+    porta.h \
+    arenaportas.h \
+    circuitocompilado.h \
+    kernelsimd.h \
+    tabelaverdade.h \
+    otimizar.h \
+    arquivomapeado.h \
+    leitortexto.h \
+    importar.h \
+    exportartabela.h \
+    pooltrabalho.h
 
 FORMS    += maincircuito.ui \
     modificarconexao.ui \
@@ -0,0 +1,44 @@
+#-------------------------------------------------
+#
+# Testes automaticos do simulador (teste3.cpp)
+# Programa de console, sem Qt: qmake Testes.pro && make && ./teste3
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+CONFIG   += console c++17 thread
+CONFIG   -= qt app_bundle
+
+TARGET = teste3
+TEMPLATE = app
+
+SOURCES += teste3.cpp \
+    circuito.cpp \
+    bool3S.cpp \
+    porta.cpp \
+    arenaportas.cpp \
+    circuitocompilado.cpp \
+    kernelsimd.cpp \
+    tabelaverdade.cpp \
+    pooltrabalho.cpp \
+    otimizar.cpp \
+    arquivomapeado.cpp \
+    importar.cpp \
+    exportartabela.cpp
+
+HEADERS  += circuito.h \
+    bool3S.h \
+    bool3S64.h \
+    dominiovalor.h \
+    porta.h \
+    arenaportas.h \
+    circuitocompilado.h \
+    kernelsimd.h \
+    tabelaverdade.h \
+    pooltrabalho.h \
+    otimizar.h \
+    arquivomapeado.h \
+    leitortexto.h \
+    importar.h \
+    exportartabela.h
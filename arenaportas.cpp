@@ -0,0 +1,100 @@
+#include <new>
+#include "arenaportas.h"
+
+///
+/// CLASSE ARENA PORTAS
+///
+
+// Aloca NP posicoes vazias
+void ArenaPortas::alocar(int NP)
+{
+  liberar();
+  if (NP<=0) return;
+  slots.reset(new SlotPorta[NP]);
+  Nslots = NP;
+}
+
+// Constroi uma porta na posicao i
+ptr_Porta ArenaPortas::criar(int i, TipoPorta T, int Nin)
+{
+  void* mem = &slots[i];
+  switch (T)
+  {
+  case TipoPorta::NT:
+    return new (mem) PortaNOT();
+  case TipoPorta::AN:
+    return new (mem) PortaAND(Nin);
+  case TipoPorta::NA:
+    return new (mem) PortaNAND(Nin);
+  case TipoPorta::OR:
+    return new (mem) PortaOR(Nin);
+  case TipoPorta::NO:
+    return new (mem) PortaNOR(Nin);
+  case TipoPorta::XO:
+    return new (mem) PortaXOR(Nin);
+  case TipoPorta::NX:
+  default:
+    return new (mem) PortaNXOR(Nin);
+  }
+}
+
+///
+/// CLASSE CONEXOES PORTAS
+///
+
+// Copia: as origens de cada porta ficam consecutivas, sem posicoes livres
+ConexoesPortas::ConexoesPortas(const ConexoesPortas& C):
+  ini(C.ini.size()),
+  Nin(C.Nin),
+  ids(),
+  Nconexoes(C.Nconexoes)
+{
+  ids.reserve(Nconexoes);
+  for (int i=0; i<size(); ++i)
+  {
+    ini[i] = int(ids.size());
+    ids.insert(ids.end(), C[i], C[i]+Nin[i]);
+  }
+}
+
+// Descarta as posicoes livres, deixando as origens de cada porta consecutivas
+void ConexoesPortas::compactar()
+{
+  ConexoesPortas prov(*this);
+  ini.swap(prov.ini);
+  ids.swap(prov.ids);
+}
+
+// Altera o numero de entradas da porta i
+void ConexoesPortas::setNumInputs(int i, int N)
+{
+  if (N<0 || N==Nin[i]) return;
+  if (N>Nin[i])
+  {
+    // As origens sao copiadas para o final de ids, a menos que jah estejam lah
+    if (ini[i]+Nin[i]!=int(ids.size()))
+    {
+      int inicio = int(ids.size());
+      ids.insert(ids.end(), ids.begin()+ini[i], ids.begin()+ini[i]+Nin[i]);
+      ini[i] = inicio;
+    }
+    ids.resize(ini[i]+N, 0);
+  }
+  else if (ini[i]+Nin[i]==int(ids.size())) ids.resize(ini[i]+N);
+  Nconexoes += N-Nin[i];
+  Nin[i] = N;
+  // Evita que as posicoes livres se acumulem com as alteracoes
+  if (int(ids.size())>2*Nconexoes+64) compactar();
+}
+
+// Substitui todas as conexoes pelas de vetores CSR
+void ConexoesPortas::atribuir(const std::vector<int>& iniIn, const std::vector<int>& idIn)
+{
+  for (int i=0; i<size(); ++i)
+  {
+    ini[i] = iniIn[i];
+    Nin[i] = iniIn[i+1]-iniIn[i];
+  }
+  ids = idIn;
+  Nconexoes = int(ids.size());
+}
@@ -0,0 +1,143 @@
+#ifndef _ARENAPORTAS_H_
+#define _ARENAPORTAS_H_
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "porta.h"
+
+///
+/// CLASSE ARENA PORTAS
+///
+/// Memoria contigua para as portas de um circuito, com uma posicao (slot) por porta:
+/// a porta de indice i (id=i+1) eh sempre construida no slot i.
+/// Todas as posicoes sao alocadas de uma soh vez (alocar) e liberadas de uma soh vez
+/// (liberar), de modo que criar, copiar ou destruir um circuito com NP portas faz uma
+/// unica alocacao de memoria, e nao NP chamadas de new/delete.
+/// As portas sao criadas por "placement new" e destruidas chamando o destrutor;
+/// a arena nao sabe quais posicoes estao ocupadas (quem sabe eh o circuito).
+///
+
+class ArenaPortas
+{
+private:
+  // Uma posicao da arena: grande o bastante e alinhada para qualquer tipo de porta
+  using SlotPorta = std::aligned_union<0, PortaNOT, PortaAND, PortaNAND, PortaOR,
+                                       PortaNOR, PortaXOR, PortaNXOR>::type;
+
+  // As posicoes da arena
+  std::unique_ptr<SlotPorta[]> slots;
+  // O numero de posicoes
+  int Nslots;
+
+public:
+  // Cria uma arena vazia
+  ArenaPortas(): slots(), Nslots(0) {}
+
+  ArenaPortas(const ArenaPortas&) = delete;
+  ArenaPortas& operator=(const ArenaPortas&) = delete;
+  ArenaPortas(ArenaPortas&&) = default;
+  ArenaPortas& operator=(ArenaPortas&&) = default;
+
+  // Numero de posicoes da arena
+  int size() const
+  {
+    return Nslots;
+  }
+
+  // Aloca NP posicoes, todas vazias, liberando as anteriores.
+  // As portas que estavam nas posicoes anteriores ja devem ter sido destruidas.
+  void alocar(int NP);
+
+  // Libera todas as posicoes.
+  // As portas que estavam nelas ja devem ter sido destruidas.
+  void liberar() noexcept
+  {
+    slots.reset();
+    Nslots = 0;
+  }
+
+  // Constroi, na posicao i (que deve estar vazia), uma porta do tipo T com Nin entradas
+  // e retorna o ponteiro para ela.
+  ptr_Porta criar(int i, TipoPorta T, int Nin);
+
+  // Destroi uma porta criada na arena (nao faz nada se P==nullptr).
+  // A posicao que ela ocupava fica vazia e pode ser reutilizada.
+  static void destruir(ptr_Porta P) noexcept
+  {
+    if (P!=nullptr) P->~Porta();
+  }
+};
+
+///
+/// CLASSE CONEXOES PORTAS
+///
+/// As ids das origens das entradas de todas as portas de um circuito, em vetores
+/// contiguos (formato CSR): as origens das entradas da porta de indice i (id=i+1) sao
+/// ids[ini[i]] ... ids[ini[i]+Nin[i]-1]. Assim como as portas na arena, todas as
+/// conexoes ocupam uma unica alocacao, e nao um vetor por porta.
+/// Quando uma porta passa a ter mais entradas, as suas origens sao copiadas para o
+/// final de ids (a posicao anterior fica livre, sem deslocar as demais portas); as
+/// posicoes livres sao descartadas na copia ou quando passam a ser a maioria.
+///
+
+class ConexoesPortas
+{
+private:
+  // Inicio das origens de cada porta em ids
+  std::vector<int> ini;
+  // Numero de entradas de cada porta
+  std::vector<int> Nin;
+  // As origens das entradas de todas as portas
+  std::vector<int> ids;
+  // Numero de conexoes (soma de Nin), menor que ids.size() se houver posicoes livres
+  int Nconexoes;
+
+  // Descarta as posicoes livres de ids
+  void compactar();
+
+public:
+  // Conexoes de NP portas, todas sem entradas
+  explicit ConexoesPortas(int NP=0): ini(NP, 0), Nin(NP, 0), ids(), Nconexoes(0) {}
+  // Copia (sem as posicoes livres)
+  ConexoesPortas(const ConexoesPortas& C);
+  ConexoesPortas(ConexoesPortas&&) = default;
+  ConexoesPortas& operator=(const ConexoesPortas&) = delete;
+  ConexoesPortas& operator=(ConexoesPortas&&) = default;
+
+  // Numero de portas
+  int size() const
+  {
+    return int(Nin.size());
+  }
+  // Numero de entradas da porta i
+  int getNumInputs(int i) const
+  {
+    return Nin[i];
+  }
+  // Numero total de conexoes
+  int getNumConexoes() const
+  {
+    return Nconexoes;
+  }
+
+  // As origens das entradas da porta i (getNumInputs(i) valores consecutivos)
+  const int* operator[](int i) const
+  {
+    return ids.data()+ini[i];
+  }
+  int* operator[](int i)
+  {
+    return ids.data()+ini[i];
+  }
+
+  // A porta i passa a ter N entradas: as origens das entradas que jah existiam sao
+  // mantidas e as das novas entradas sao 0 (indefinidas)
+  void setNumInputs(int i, int N);
+
+  // Substitui todas as conexoes pelas de vetores CSR: a porta i tem as origens
+  // idIn[iniIn[i]] ... idIn[iniIn[i+1]-1] (iniIn tem dimensao size()+1)
+  void atribuir(const std::vector<int>& iniIn, const std::vector<int>& idIn);
+};
+
+#endif // _ARENAPORTAS_H_
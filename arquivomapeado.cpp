@@ -0,0 +1,130 @@
+#include "arquivomapeado.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+///
+/// CLASSE ARQUIVO MAPEADO
+///
+
+// Cria um objeto sem arquivo aberto
+ArquivoMapeado::ArquivoMapeado():
+  dados(nullptr),
+  tamanho(0),
+  abriu(false)
+#ifdef _WIN32
+  , hArquivo(INVALID_HANDLE_VALUE),
+  hMapa(nullptr)
+#endif
+{
+}
+
+// Cria o objeto e abre o arquivo arq
+ArquivoMapeado::ArquivoMapeado(const std::string& arq): ArquivoMapeado()
+{
+  abrir(arq);
+}
+
+// Desfaz o mapeamento
+ArquivoMapeado::~ArquivoMapeado()
+{
+  fechar();
+}
+
+#ifdef _WIN32
+
+// Abre o arquivo e o mapeia na memoria (Windows)
+bool ArquivoMapeado::abrir(const std::string& arq)
+{
+  fechar();
+
+  hArquivo = CreateFileA(arq.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (hArquivo==INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER N;
+  if (!GetFileSizeEx(hArquivo, &N))
+  {
+    fechar();
+    return false;
+  }
+  tamanho = size_t(N.QuadPart);
+  abriu = true;
+  // Um arquivo vazio nao pode ser mapeado: fica aberto, sem dados
+  if (tamanho==0) return true;
+
+  hMapa = CreateFileMappingA(hArquivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (hMapa!=nullptr) dados = static_cast<const char*>(MapViewOfFile(hMapa, FILE_MAP_READ, 0, 0, 0));
+  if (dados==nullptr)
+  {
+    fechar();
+    return false;
+  }
+  return true;
+}
+
+// Desfaz o mapeamento e fecha o arquivo (Windows)
+void ArquivoMapeado::fechar() noexcept
+{
+  if (dados!=nullptr) UnmapViewOfFile(dados);
+  if (hMapa!=nullptr) CloseHandle(hMapa);
+  if (hArquivo!=INVALID_HANDLE_VALUE) CloseHandle(hArquivo);
+  dados = nullptr;
+  tamanho = 0;
+  abriu = false;
+  hArquivo = INVALID_HANDLE_VALUE;
+  hMapa = nullptr;
+}
+
+#else
+
+// Abre o arquivo e o mapeia na memoria (POSIX)
+bool ArquivoMapeado::abrir(const std::string& arq)
+{
+  fechar();
+
+  int fd = open(arq.c_str(), O_RDONLY);
+  if (fd<0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st)!=0 || !S_ISREG(st.st_mode))
+  {
+    close(fd);
+    return false;
+  }
+  tamanho = size_t(st.st_size);
+  // Um arquivo vazio nao pode ser mapeado: fica aberto, sem dados
+  if (tamanho>0)
+  {
+    void* p = mmap(nullptr, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p==MAP_FAILED)
+    {
+      close(fd);
+      tamanho = 0;
+      return false;
+    }
+    dados = static_cast<const char*>(p);
+  }
+  // O mapeamento continua valido depois que o descritor eh fechado
+  close(fd);
+  abriu = true;
+  return true;
+}
+
+// Desfaz o mapeamento (POSIX)
+void ArquivoMapeado::fechar() noexcept
+{
+  if (dados!=nullptr) munmap(const_cast<char*>(dados), tamanho);
+  dados = nullptr;
+  tamanho = 0;
+  abriu = false;
+}
+
+#endif
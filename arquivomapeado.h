@@ -0,0 +1,69 @@
+#ifndef _ARQUIVOMAPEADO_H_
+#define _ARQUIVOMAPEADO_H_
+
+#include <string>
+#include <cstddef>
+
+///
+/// CLASSE ARQUIVO MAPEADO
+///
+/// Um arquivo aberto somente para leitura e mapeado na memoria (mmap no Linux/macOS,
+/// MapViewOfFile no Windows): o conteudo do arquivo eh acessado diretamente como um
+/// vetor de bytes, sem copias para buffers intermediarios. As paginas soh sao lidas
+/// do disco quando acessadas pela primeira vez.
+/// O mapeamento eh desfeito quando o objeto eh destruido (ou com fechar).
+///
+
+class ArquivoMapeado
+{
+private:
+  // O conteudo do arquivo (nullptr se nao houver arquivo aberto ou se ele for vazio)
+  const char* dados;
+  // O tamanho do arquivo em bytes
+  size_t tamanho;
+  // true se ha um arquivo aberto
+  bool abriu;
+#ifdef _WIN32
+  // Os handles do arquivo e do mapeamento (Windows)
+  void* hArquivo;
+  void* hMapa;
+#endif
+
+public:
+  // Cria um objeto sem arquivo aberto
+  ArquivoMapeado();
+  // Cria o objeto e abre o arquivo arq (testar com aberto())
+  explicit ArquivoMapeado(const std::string& arq);
+  // Desfaz o mapeamento
+  ~ArquivoMapeado();
+
+  ArquivoMapeado(const ArquivoMapeado&) = delete;
+  ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
+
+  // Abre o arquivo arq e o mapeia na memoria, fechando o anterior.
+  // Retorna false se nao conseguiu abrir ou mapear o arquivo.
+  bool abrir(const std::string& arq);
+
+  // Desfaz o mapeamento e fecha o arquivo
+  void fechar() noexcept;
+
+  // Retorna true se ha um arquivo aberto (que pode ser vazio)
+  bool aberto() const
+  {
+    return abriu;
+  }
+
+  // O conteudo do arquivo
+  const char* getDados() const
+  {
+    return dados;
+  }
+
+  // O tamanho do arquivo em bytes
+  size_t getTamanho() const
+  {
+    return tamanho;
+  }
+};
+
+#endif // _ARQUIVOMAPEADO_H_
@@ -0,0 +1,663 @@
+// Programa de medicao de desempenho do simulador (nao faz parte do aplicativo Qt).
+//
+// Compilacao: qmake Benchmark.pro && make
+// ou (exemplo com g++):
+// g++ -std=c++17 -O2 -o benchmark benchmark.cpp circuito.cpp circuitocompilado.cpp
+//     kernelsimd.cpp tabelaverdade.cpp pooltrabalho.cpp porta.cpp arenaportas.cpp bool3S.cpp
+//     otimizar.cpp arquivomapeado.cpp importar.cpp exportartabela.cpp -pthread
+//
+// Uso: benchmark                 (circuitos aleatorios)
+//      benchmark arquivo.bench   (simulacao de um circuito importado: .bench, .blif ou .v)
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <new>
+
+#include "circuito.h"
+#include "tabelaverdade.h"
+#include "otimizar.h"
+#include "importar.h"
+#include "exportartabela.h"
+
+using namespace std;
+
+// Contador das alocacoes de memoria do programa: os operadores new e delete globais
+// sao substituidos por versoes que contam as chamadas.
+atomic<long long> Nalocacoes(0);
+
+void* operator new(size_t N)
+{
+  ++Nalocacoes;
+  if (void* p = malloc(N>0 ? N : 1)) return p;
+  throw bad_alloc();
+}
+void* operator new(size_t N, align_val_t A)
+{
+  ++Nalocacoes;
+  size_t alin = size_t(A);
+  if (void* p = aligned_alloc(alin, (N+alin-1)/alin*alin)) return p;
+  throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, align_val_t) noexcept { free(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { free(p); }
+
+// Cria um circuito aleatorio sem lacos, com NI entradas, NO saidas e NP portas.
+// Cada porta (exceto NT) tem de 2 a MaxIn entradas, vindas de entradas do circuito
+// ou de portas anteriores.
+Circuito circuitoAleatorio(int NI, int NO, int NP, int MaxIn, unsigned semente)
+{
+  static const char* tipos[] = {"NT","AN","NA","OR","NO","XO","NX"};
+  mt19937 gerador(semente);
+  Circuito C(NI,NO,NP);
+
+  for (int id=1; id<=NP; ++id)
+  {
+    string tipo = tipos[gerador()%7];
+    int nin = (tipo=="NT" ? 1 : 2+gerador()%(MaxIn-1));
+    C.setPort(id, tipo, nin);
+    for (int j=0; j<nin; ++j)
+    {
+      // Preferencialmente conecta a portas proximas, para gerar circuitos profundos
+      int r = gerador()%(NI+min(id-1,64));
+      C.setIdInPort(id, j, (r<NI ? -(r+1) : id-1-(r-NI)));
+    }
+  }
+  for (int id=1; id<=NO; ++id) C.setIdOutputCirc(id, NP-id+1);
+  return C;
+}
+
+// Cria um circuito com cada porta de C duplicada, como os gerados por algumas ferramentas:
+// as portas 2*id-1 e 2*id sao copias da porta id de C, e cada entrada de cada copia vem
+// de uma das duas copias da porta de origem (escolhida ao acaso)
+Circuito circuitoDuplicado(const Circuito& C, unsigned semente)
+{
+  mt19937 gerador(semente);
+  Circuito D(C.getNumInputs(), C.getNumOutputs(), 2*C.getNumPorts());
+  auto copia = [&](int IdOrig) { return (IdOrig>0 ? 2*IdOrig-int(gerador()%2) : IdOrig); };
+
+  for (int id=1; id<=C.getNumPorts(); ++id)
+  {
+    for (int c=0; c<2; ++c)
+    {
+      string tipo = C.getNamePort(id);
+      D.setPort(2*id-c, tipo, C.getNumInputsPort(id));
+      for (int j=0; j<C.getNumInputsPort(id); ++j) D.setIdInPort(2*id-c, j, copia(C.getIdInPort(id, j)));
+    }
+  }
+  for (int id=1; id<=C.getNumOutputs(); ++id) D.setIdOutputCirc(id, copia(C.getIdOutputCirc(id)));
+  return D;
+}
+
+// Retorna 64 valores bool3S aleatorios (codificacao dual-rail)
+bool3S_64 aleatorio64(mt19937_64& gerador)
+{
+  uint64_t t = gerador();
+  return bool3S_64{t, ~t & gerador()};
+}
+
+// Tempo decorrido (em segundos) desde o instante inicio
+double segundosDesde(chrono::steady_clock::time_point inicio)
+{
+  return chrono::duration<double>(chrono::steady_clock::now()-inicio).count();
+}
+
+// Imprime uma linha de resultado em vetores de entrada por segundo
+void imprimirVazao(const string& nome, double vetores, double segundos)
+{
+  cout << "  " << left << setw(24) << nome << right << setw(14) << fixed << setprecision(0)
+       << vetores/segundos << " vetores/s" << endl;
+}
+
+// Imprime uma linha de resultado em operacoes por segundo
+void imprimirOperacoes(const string& nome, double operacoes, double segundos)
+{
+  cout << "  " << left << setw(24) << nome << right << setw(14) << fixed << setprecision(0)
+       << operacoes/segundos << " operacoes/s" << endl;
+}
+
+// Implementacao antiga (com desvios) do AND 3S, usada apenas para comparacao.
+// Nao eh expandida em linha, como quando os operadores ficavam em bool3S.cpp.
+__attribute__((noinline)) bool3S andComDesvios(bool3S x1, bool3S x2)
+{
+  if (x1==bool3S::FALSE || x2==bool3S::FALSE) return bool3S::FALSE;
+  if (x1==bool3S::UNDEF || x2==bool3S::UNDEF) return bool3S::UNDEF;
+  return bool3S::TRUE;
+}
+
+// Implementacao antiga (com desvios) do XOR 3S, usada apenas para comparacao
+__attribute__((noinline)) bool3S xorComDesvios(bool3S x1, bool3S x2)
+{
+  if (x1==bool3S::UNDEF || x2==bool3S::UNDEF) return bool3S::UNDEF;
+  if (x1==x2) return bool3S::FALSE;
+  return bool3S::TRUE;
+}
+
+// Compara os operadores bool3S por tabela com a implementacao antiga com desvios,
+// aplicando-os a valores aleatorios (desvios imprevisiveis)
+void benchmarkOperadores()
+{
+  const int N = 1<<20;
+  const int repeticoes = 20;
+  mt19937 gerador(3);
+  vector<bool3S> x(N), y(N);
+  for (int i=0; i<N; ++i)
+  {
+    x[i] = bool3S(gerador()%3);
+    y[i] = bool3S(gerador()%3);
+  }
+
+  cout << "OPERADORES bool3S (" << sizeof(bool3S) << " byte por valor)\n";
+
+  // Como na simulacao de uma porta, cada resultado depende do anterior
+  bool3S acum = bool3S::UNDEF;
+  auto inicio = chrono::steady_clock::now();
+  for (int r=0; r<repeticoes; ++r)
+    for (int i=0; i<N; ++i) acum = xorComDesvios(andComDesvios(acum, x[i]), y[i]);
+  imprimirOperacoes("com desvios", 2.0*repeticoes*N, segundosDesde(inicio));
+  bool3S conferencia = acum;
+
+  acum = bool3S::UNDEF;
+  inicio = chrono::steady_clock::now();
+  for (int r=0; r<repeticoes; ++r)
+    for (int i=0; i<N; ++i) acum = (acum & x[i]) ^ y[i];
+  imprimirOperacoes("por tabela", 2.0*repeticoes*N, segundosDesde(inicio));
+  if (acum!=conferencia) cout << "  ERRO: resultados diferentes\n";
+}
+
+// Imprime uma linha de resultado em tempo (milissegundos)
+void imprimirTempo(const string& nome, double segundos)
+{
+  cout << "  " << left << setw(24) << nome << right << setw(14) << fixed << setprecision(1)
+       << 1000.0*segundos << " ms" << endl;
+}
+
+// A estrutura de um circuito na organizacao anterior aa arena, usada apenas para
+// comparacao: uma porta alocada com new e um vetor de conexoes para cada porta
+struct EstruturaPorPorta
+{
+  vector<ptr_Porta> ports;
+  vector< vector<int> > id_in;
+  vector<int> id_out;
+
+  // Cria uma porta do tipo T com Nin entradas com new
+  static ptr_Porta novaPorta(TipoPorta T, int Nin)
+  {
+    switch (T)
+    {
+    case TipoPorta::NT: return new PortaNOT();
+    case TipoPorta::AN: return new PortaAND(Nin);
+    case TipoPorta::NA: return new PortaNAND(Nin);
+    case TipoPorta::OR: return new PortaOR(Nin);
+    case TipoPorta::NO: return new PortaNOR(Nin);
+    case TipoPorta::XO: return new PortaXOR(Nin);
+    case TipoPorta::NX: default: return new PortaNXOR(Nin);
+    }
+  }
+
+  // Monta a estrutura a partir de vetores CSR (como Circuito::montar)
+  EstruturaPorPorta(const vector<TipoPorta>& tipo, const vector<int>& iniIn,
+                    const vector<int>& idIn, const vector<int>& idOut):
+    ports(tipo.size()), id_in(tipo.size()), id_out(idOut)
+  {
+    for (size_t i=0; i<tipo.size(); ++i)
+    {
+      ports[i] = novaPorta(tipo[i], iniIn[i+1]-iniIn[i]);
+      id_in[i].assign(idIn.begin()+iniIn[i], idIn.begin()+iniIn[i+1]);
+    }
+  }
+  // Copia: cada porta eh clonada e cada vetor de conexoes eh copiado
+  EstruturaPorPorta(const EstruturaPorPorta& E):
+    ports(E.ports.size()), id_in(E.id_in), id_out(E.id_out)
+  {
+    for (size_t i=0; i<ports.size(); ++i) ports[i] = E.ports[i]->clone();
+  }
+  ~EstruturaPorPorta()
+  {
+    for (ptr_Porta p : ports) delete p;
+  }
+};
+
+// Imprime o tempo e o numero de alocacoes de uma etapa
+void imprimirEtapa(const string& nome, double segundos, long long alocacoes)
+{
+  cout << "  " << left << setw(24) << nome << right << setw(14) << fixed << setprecision(1)
+       << 1000.0*segundos << " ms" << setw(12) << alocacoes << " alocacoes" << endl;
+}
+
+// Mede a montagem, a copia e a destruicao da estrutura de um circuito grande (portas na
+// arena e conexoes em vetores contiguos), comparando com a organizacao anterior
+// (EstruturaPorPorta). As duas recebem os mesmos dados (vetores CSR, sem a leitura do
+// arquivo) e fazem o mesmo trabalho: a copia do circuito eh seguida de uma alteracao,
+// que obriga a duplicar a estrutura compartilhada.
+void benchmarkMemoria(const Circuito& C)
+{
+  const int NP = C.getNumPorts();
+
+  // Os dados do circuito em vetores CSR
+  vector<TipoPorta> tipo(NP);
+  vector<int> iniIn(NP+1, 0), idIn, idOut;
+  for (int id=1; id<=NP; ++id)
+  {
+    string nome = C.getNamePort(id);
+    tipoPorta(nome, tipo[id-1]);
+    iniIn[id] = iniIn[id-1] + C.getNumInputsPort(id);
+    for (int I=0; I<C.getNumInputsPort(id); ++I) idIn.push_back(C.getIdInPort(id, I));
+  }
+  for (int id=1; id<=C.getNumOutputs(); ++id) idOut.push_back(C.getIdOutputCirc(id));
+  cout << "MEMORIA (" << NP << " portas, " << idIn.size() << " conexoes)\n";
+
+  for (int org=0; org<2; ++org)
+  {
+    const string sufixo = (org==0 ? " (arena)" : " (por porta)");
+    long long antes = Nalocacoes;
+    auto inicio = chrono::steady_clock::now();
+    // Imprime a etapa que terminou e comeca a medir a proxima
+    auto etapa = [&](const string& nome)
+    {
+      const double segundos = segundosDesde(inicio);
+      const long long alocacoes = Nalocacoes-antes;
+      imprimirEtapa(nome+sufixo, segundos, alocacoes);
+      antes = Nalocacoes;
+      inicio = chrono::steady_clock::now();
+    };
+
+    if (org==0)
+    {
+      Circuito M;
+      M.montar(C.getNumInputs(), tipo, iniIn, idIn, idOut);
+      etapa("montar");
+      Circuito* copia = new Circuito(M);
+      copia->setIdOutputCirc(1, M.getIdOutputCirc(1));
+      etapa("copiar");
+      delete copia;
+      etapa("destruir");
+    }
+    else
+    {
+      EstruturaPorPorta M(tipo, iniIn, idIn, idOut);
+      etapa("montar");
+      EstruturaPorPorta* copia = new EstruturaPorPorta(M);
+      etapa("copiar");
+      delete copia;
+      etapa("destruir");
+    }
+  }
+}
+
+// Compara a leitura de um circuito grande com ler (ifstream) e com lerRapido
+// (arquivo mapeado na memoria, leitura direta dos numeros)
+void benchmarkLeitura(const Circuito& C)
+{
+  const string arq = "benchmark_leitura.txt";
+  C.salvar(arq);
+  ifstream tam(arq, ios::binary | ios::ate);
+  const double MB = double(tam.tellg())/(1024.0*1024.0);
+  tam.close();
+  cout << "LEITURA (" << C.getNumPorts() << " portas, " << fixed << setprecision(1)
+       << MB << " MB)\n";
+
+  Circuito L;
+  auto inicio = chrono::steady_clock::now();
+  L.ler(arq);
+  const double segundosLer = segundosDesde(inicio);
+  imprimirTempo("ler", segundosLer);
+
+  Circuito R;
+  inicio = chrono::steady_clock::now();
+  R.lerRapido(arq);
+  const double segundosRapido = segundosDesde(inicio);
+  imprimirTempo("lerRapido", segundosRapido);
+  cout << "  " << left << setw(24) << "aceleracao" << right << setw(14) << fixed
+       << setprecision(1) << segundosLer/segundosRapido << " x" << endl;
+  if (!(R==L) || !(R==C)) cout << "  ERRO: os circuitos lidos sao diferentes\n";
+  remove(arq.c_str());
+}
+
+// Compara o tempo para ter um circuito grande pronto para simular a partir do arquivo
+// texto (ler e compilar) e do arquivo binario (mapeado na memoria, jah compilado)
+void benchmarkBinario(const Circuito& C)
+{
+  const string texto = "benchmark_binario.txt";
+  const string binario = "benchmark_binario.bin";
+  C.salvar(texto);
+  C.salvarBinario(binario);
+  cout << "ARQUIVO BINARIO (" << C.getNumPorts() << " portas)\n";
+
+  Circuito T;
+  auto inicio = chrono::steady_clock::now();
+  T.lerRapido(texto);
+  T.getCompilado();
+  imprimirTempo("lerRapido + compilar", segundosDesde(inicio));
+
+  Circuito B;
+  inicio = chrono::steady_clock::now();
+  B.lerBinario(binario);
+  imprimirTempo("Circuito::lerBinario", segundosDesde(inicio));
+
+  CircuitoCompilado CC;
+  inicio = chrono::steady_clock::now();
+  CC.lerBinario(binario);
+  imprimirTempo("Compilado::lerBinario", segundosDesde(inicio));
+
+  if (!(B==T) || CC.getNumPorts()!=C.getNumPorts())
+    cout << "  ERRO: os circuitos lidos sao diferentes\n";
+  remove(texto.c_str());
+  remove(binario.c_str());
+}
+
+// Conta as alocacoes de memoria feitas pelas simulacoes de um circuito que nao muda,
+// depois da primeira chamada (que monta a representacao compilada)
+void benchmarkAlocacoes(Circuito& C)
+{
+  const int NI = C.getNumInputs();
+  const int repeticoes = 100;
+  mt19937 gerador(4);
+  vector<bool3S> in(NI);
+  vector<bool3S_64> in64(NI, toBool3S_64(bool3S::TRUE));
+  vector<bool3S_bloco> inBloco(NI, toBool3S_bloco(bool3S::FALSE));
+  long long antes;
+
+  cout << "ALOCACOES DE MEMORIA (por chamada, apos a primeira)\n";
+  auto imprimir = [&](const string& nome)
+  {
+    cout << "  " << left << setw(24) << nome << right << setw(14) << fixed << setprecision(2)
+         << double(Nalocacoes-antes)/repeticoes << " alocacoes" << endl;
+  };
+
+  C.simular(in);
+  antes = Nalocacoes;
+  for (int r=0; r<repeticoes; ++r)
+  {
+    in[gerador()%NI] = bool3S(gerador()%3);
+    C.simular(in);
+  }
+  imprimir("simular");
+
+  C.simularEventos(in);
+  antes = Nalocacoes;
+  for (int r=0; r<repeticoes; ++r)
+  {
+    in[gerador()%NI] = bool3S(gerador()%3);
+    C.simularEventos(in);
+  }
+  imprimir("simularEventos");
+
+  C.simular64(in64);
+  antes = Nalocacoes;
+  for (int r=0; r<repeticoes; ++r) C.simular64(in64);
+  imprimir("simular64");
+
+  C.simularBloco(inBloco);
+  antes = Nalocacoes;
+  for (int r=0; r<repeticoes; ++r) C.simularBloco(inBloco);
+  imprimir("simularBloco");
+
+  // Uma porta isolada, simulada com um trecho de um vetor reaproveitado
+  PortaNAND P(2);
+  antes = Nalocacoes;
+  for (int r=0; r<repeticoes; ++r) P.simular(in.data()+r%(NI-1), 2);
+  imprimir("Porta::simular");
+}
+
+// Mede o custo de Circuito::simular em um circuito pequeno que nao muda, comparado com
+// a simulacao direta da representacao compilada: a diferenca eh a sobrecarga por vetor
+// (testes de validade, copia das saidas)
+void benchmarkSobrecarga()
+{
+  Circuito C = circuitoAleatorio(8, 4, 32, 3, 2027);
+  const CircuitoCompilado& comp = C.getCompilado();
+  const int vetores = 2000000;
+  vector<bool3S> in(C.getNumInputs(), bool3S::FALSE);
+  vector<bool3S> V(comp.getNumSinais());
+
+  cout << "SOBRECARGA POR VETOR (" << C.getNumPorts() << " portas)\n";
+
+  auto inicio = chrono::steady_clock::now();
+  for (int r=0; r<vetores; ++r)
+  {
+    ++in[r%C.getNumInputs()];
+    comp.simular(in.data(), V.data());
+  }
+  imprimirVazao("CircuitoCompilado", vetores, segundosDesde(inicio));
+
+  inicio = chrono::steady_clock::now();
+  for (int r=0; r<vetores; ++r)
+  {
+    ++in[r%C.getNumInputs()];
+    C.simular(in);
+  }
+  imprimirVazao("Circuito::simular", vetores, segundosDesde(inicio));
+}
+
+// Compara as simulacoes escalar, bit-paralela (64) e vetorial (cada kernel SIMD)
+void benchmarkKernels(Circuito& C)
+{
+  const int NI = C.getNumInputs();
+  const int repeticoes = 50;
+  mt19937 gerador(1);
+  mt19937_64 gerador64(1);
+
+  cout << "KERNELS (" << C.getNumPorts() << " portas, melhor kernel da CPU: "
+       << nomeSIMD(nivelSIMD()) << ")\n";
+
+  // Escalar (um vetor por vez)
+  vector<bool3S> in(NI);
+  auto inicio = chrono::steady_clock::now();
+  for (int r=0; r<repeticoes*64; ++r)
+  {
+    for (auto& x : in) x = bool3S(gerador()%3);
+    C.simular(in);
+  }
+  imprimirVazao("simular", repeticoes*64, segundosDesde(inicio));
+
+  // Bit-paralela (64 vetores por vez)
+  vector<bool3S_64> in64(NI);
+  for (auto& x : in64) x = aleatorio64(gerador64);
+  inicio = chrono::steady_clock::now();
+  for (int r=0; r<repeticoes*8; ++r) C.simular64(in64);
+  imprimirVazao("simular64", repeticoes*8*64.0, segundosDesde(inicio));
+
+  // Vetorial (BOOL3S_BLOCO vetores por vez), com cada kernel suportado
+  vector<bool3S_bloco> inBloco(NI);
+  for (auto& x : inBloco)
+  {
+    for (int w=0; w<PALAVRAS_BLOCO; ++w)
+    {
+      bool3S_64 prov = aleatorio64(gerador64);
+      x.t[w] = prov.t;
+      x.f[w] = prov.f;
+    }
+  }
+  for (NivelSIMD N : {NivelSIMD::ESCALAR, NivelSIMD::AVX2, NivelSIMD::AVX512})
+  {
+    KernelPorta K = kernelPorta(N);
+    if (K==nullptr)
+    {
+      cout << "  " << left << setw(24) << nomeSIMD(N) << right << "   (nao suportado)\n";
+      continue;
+    }
+    inicio = chrono::steady_clock::now();
+    for (int r=0; r<repeticoes; ++r) C.simularBloco(inBloco, K);
+    imprimirVazao(string("simularBloco ")+nomeSIMD(N), double(repeticoes)*BOOL3S_BLOCO,
+                  segundosDesde(inicio));
+  }
+}
+
+// Compara a simulacao completa com a dirigida por eventos, quando
+// vetores consecutivos diferem em uma unica entrada
+void benchmarkEventos(Circuito& C)
+{
+  const int NI = C.getNumInputs();
+  const int vetores = 2000;
+  mt19937 gerador(2);
+  vector<bool3S> in(NI, bool3S::FALSE);
+
+  cout << "EVENTOS (uma entrada muda por vetor)\n";
+
+  auto inicio = chrono::steady_clock::now();
+  for (int r=0; r<vetores; ++r)
+  {
+    ++in[gerador()%NI];
+    C.simular(in);
+  }
+  imprimirVazao("simular", vetores, segundosDesde(inicio));
+
+  inicio = chrono::steady_clock::now();
+  for (int r=0; r<vetores; ++r)
+  {
+    ++in[gerador()%NI];
+    C.simularEventos(in);
+  }
+  imprimirVazao("simularEventos", vetores, segundosDesde(inicio));
+}
+
+// Mede a geracao paralela da tabela verdade com numeros crescentes de threads
+void benchmarkTabelaParalela(Circuito& C)
+{
+  const CircuitoCompilado& comp = C.getCompilado();
+  int maxThreads = max(1u, thread::hardware_concurrency());
+
+  cout << "TABELA VERDADE PARALELA (" << numLinhasTabela(C.getNumInputs()) << " linhas)\n";
+  for (int Nthreads=1; Nthreads<=maxThreads; Nthreads*=2)
+  {
+    PoolTrabalho P(Nthreads);
+    auto inicio = chrono::steady_clock::now();
+    gerarTabelaParalela(comp, P, [](long long, int, const bool3S*) { return true; });
+    imprimirVazao(to_string(Nthreads)+" threads", numLinhasTabela(C.getNumInputs()),
+                  segundosDesde(inicio));
+  }
+}
+
+// Mede o hash estrutural de um circuito com portas duplicadas e compara a simulacao
+// do circuito original com a do circuito sem duplicatas
+void benchmarkHashEstrutural(Circuito C)
+{
+  const int repeticoes = 20;
+  ResultadoOtimizacao R;
+
+  cout << "HASH ESTRUTURAL (" << C.getNumPorts() << " portas)\n";
+  auto inicio = chrono::steady_clock::now();
+  hashEstrutural(C, R);
+  imprimirTempo("hashEstrutural", segundosDesde(inicio));
+  R.escreverRelatorio(cout);
+
+  vector<bool3S_64> in64(C.getNumInputs(), toBool3S_64(bool3S::TRUE));
+  for (Circuito* P : {&C, &R.circ})
+  {
+    P->simular64(in64);
+    inicio = chrono::steady_clock::now();
+    for (int r=0; r<repeticoes; ++r) P->simular64(in64);
+    imprimirVazao(P==&C ? "simular64 original" : "simular64 otimizado", repeticoes*64.0,
+                  segundosDesde(inicio));
+  }
+}
+
+// Compara a tabela verdade ternaria (3^N linhas) com a binaria (2^N linhas)
+void benchmarkTabelaBinaria(Circuito& C)
+{
+  const int NI = C.getNumInputs();
+  auto receptor = [](long long, const bool3S*, const bool3S*) { return true; };
+
+  cout << "TABELA VERDADE BINARIA (" << NI << " entradas)\n";
+
+  auto inicio = chrono::steady_clock::now();
+  C.gerarTabela(receptor, OrdemTabela::GRAY);
+  double ternaria = segundosDesde(inicio);
+  imprimirTempo(to_string(numLinhasTabela(NI))+" linhas ternarias", ternaria);
+
+  inicio = chrono::steady_clock::now();
+  C.gerarTabelaBinaria(receptor);
+  double binaria = segundosDesde(inicio);
+  imprimirTempo(to_string(numLinhasTabelaBinaria(NI))+" linhas binarias", binaria);
+  imprimirVazao("linhas binarias", numLinhasTabelaBinaria(NI), binaria);
+}
+
+// Compara a geracao da tabela verdade (sem guardar as linhas) com a sua exportacao
+// para um arquivo, nos dois formatos
+void benchmarkExportacao(Circuito& C)
+{
+  const string binario = "benchmark_tabela.tab";
+  const string csv = "benchmark_tabela.csv";
+  const long long total = numLinhasTabela(C.getNumInputs());
+  PoolTrabalho P(max(1u, thread::hardware_concurrency()));
+
+  cout << "EXPORTACAO DA TABELA VERDADE (" << total << " linhas)\n";
+  auto inicio = chrono::steady_clock::now();
+  C.gerarTabela([](long long, const bool3S*, const bool3S*) { return true; }, P);
+  imprimirVazao("gerarTabela", total, segundosDesde(inicio));
+
+  inicio = chrono::steady_clock::now();
+  bool ok = exportarTabela(C, binario, FormatoTabela::BINARIO, false, &P);
+  imprimirVazao("exportar binario", total, segundosDesde(inicio));
+
+  inicio = chrono::steady_clock::now();
+  ok = exportarTabela(C, csv, FormatoTabela::CSV, false, &P) && ok;
+  imprimirVazao("exportar CSV", total, segundosDesde(inicio));
+
+  if (!ok) cout << "  ERRO: a tabela nao foi exportada\n";
+  remove(binario.c_str());
+  remove(csv.c_str());
+}
+
+// Mede as simulacoes de um circuito importado de um arquivo .bench, .blif ou .v
+int benchmarkArquivo(const string& arq)
+{
+  Circuito C;
+  NomesCircuito N;
+  ErroLeitura E;
+  auto inicio = chrono::steady_clock::now();
+  if (!importarNetlist(arq, C, &N, &E))
+  {
+    cerr << arq << ": " << E.texto() << endl;
+    return 1;
+  }
+  cout << arq << ": " << C.getNumInputs() << " entradas (" << N.Nflipflops
+       << " flip-flops), " << C.getNumOutputs() << " saidas, " << C.getNumPorts() << " portas\n";
+  imprimirTempo("importarNetlist", segundosDesde(inicio));
+
+  benchmarkKernels(C);
+  benchmarkEventos(C);
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc>1) return benchmarkArquivo(argv[1]);
+
+  benchmarkOperadores();
+
+  Circuito C = circuitoAleatorio(32, 8, 20000, 8, 2024);
+
+  benchmarkSobrecarga();
+  benchmarkAlocacoes(C);
+  benchmarkKernels(C);
+  benchmarkEventos(C);
+
+  Circuito G = circuitoAleatorio(64, 8, 1000000, 4, 2026);
+  benchmarkMemoria(G);
+  benchmarkLeitura(G);
+  benchmarkBinario(G);
+
+  benchmarkHashEstrutural(circuitoDuplicado(C, 2028));
+
+  Circuito T = circuitoAleatorio(12, 8, 2000, 4, 2025);
+  benchmarkTabelaParalela(T);
+  benchmarkTabelaBinaria(T);
+
+  Circuito E = circuitoAleatorio(14, 8, 2000, 4, 2027);
+  benchmarkExportacao(E);
+
+  return 0;
+}
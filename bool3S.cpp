@@ -2,63 +2,8 @@
 
 using namespace std;
 
-//Os operadores logicos para a classe bool3S
-
-// NOT 3S
-bool3S operator~(bool3S x)
-{
-  if (x==bool3S::UNDEF) return bool3S::UNDEF;
-  if (x==bool3S::TRUE) return bool3S::FALSE;
-  return bool3S::TRUE;
-}
-
-// AND 3S
-bool3S operator&(bool3S x1, bool3S x2)
-{
-  if (x1==bool3S::FALSE || x2==bool3S::FALSE) return bool3S::FALSE;
-  if (x1==bool3S::UNDEF || x2==bool3S::UNDEF) return bool3S::UNDEF;
-  return bool3S::TRUE;
-}
-
-void operator&=(bool3S& x1, bool3S x2)
-{
-  if (x1==bool3S::FALSE) return;
-  if (x2==bool3S::FALSE) {x1=bool3S::FALSE; return;}
-  if (x1==bool3S::UNDEF || x2==bool3S::UNDEF) {x1=bool3S::UNDEF; return;}
-  x1=bool3S::TRUE;
-}
-
-// OR 3S
-bool3S operator|(bool3S x1, bool3S x2)
-{
-  if (x1==bool3S::TRUE || x2==bool3S::TRUE) return bool3S::TRUE;
-  if (x1==bool3S::UNDEF || x2==bool3S::UNDEF) return bool3S::UNDEF;
-  return bool3S::FALSE;
-}
-
-void operator|=(bool3S& x1, bool3S x2)
-{
-  if (x1==bool3S::TRUE) return;
-  if (x2==bool3S::TRUE) {x1=bool3S::TRUE; return;}
-  if (x1==bool3S::UNDEF || x2==bool3S::UNDEF) {x1=bool3S::UNDEF; return;}
-  x1=bool3S::FALSE;
-}
-
-// XOR 3S
-bool3S operator^(bool3S x1, bool3S x2)
-{
-  if (x1==bool3S::UNDEF || x2==bool3S::UNDEF) return bool3S::UNDEF;
-  if (x1==x2) return bool3S::FALSE;
-  return bool3S::TRUE;
-}
-
-void operator^=(bool3S& x1, bool3S x2)
-{
-  if (x1==bool3S::UNDEF) return;
-  if (x2==bool3S::UNDEF) {x1=bool3S::UNDEF; return;}
-  if (x1==x2) {x1=bool3S::FALSE; return;}
-  x1=bool3S::TRUE;
-}
+// Os operadores logicos para a classe bool3S (~, &, |, ^ e as formas compostas)
+// sao definidos no arquivo bool3S.h, por consulta a tabelas constexpr
 
 // Os operadores de incremento/decremento para a classe bool3S
 
@@ -126,7 +71,7 @@ char toChar(bool3S B)
 }
 
 // Converte um char (F T ?) para o bool3S correspondente
-bool3S toBool_3S(char C)
+bool3S toBool3S(char C)
 {
   C = toupper(C);
   if (C=='T') return bool3S::TRUE;
@@ -148,6 +93,6 @@ istream& operator>>(istream& I, bool3S& B)
 {
   char prov;
   I >> prov;
-  B = toBool_3S(prov);
+  B = toBool3S(prov);
   return I;
 }
@@ -5,26 +5,84 @@
 
 // Criando um tipo de dados enumerado (bool3S) para representar um booleano com 3 estados:
 // bool3S::TRUE, bool3S::FALSE e bool3S::UNDEF
-enum class bool3S {
+// O tipo subjacente eh unsigned char: cada valor ocupa 1 byte (e nao 4, como um int),
+// o que reduz a memoria e o trafego de cache dos vetores de bool3S do simulador.
+enum class bool3S : unsigned char {
   UNDEF,
   FALSE,
   TRUE
 };
 
+static_assert(sizeof(bool3S)==1, "bool3S deve ocupar 1 byte");
+
+// As tabelas verdade dos operadores logicos para a classe bool3S,
+// indexadas pelos valores dos operandos (UNDEF=0, FALSE=1, TRUE=2)
+
+// NOT 3S
+constexpr bool3S TABELA_NOT3S[3] =
+  {bool3S::UNDEF, bool3S::TRUE, bool3S::FALSE};
+// AND 3S
+constexpr bool3S TABELA_AND3S[3][3] =
+  {{bool3S::UNDEF, bool3S::FALSE, bool3S::UNDEF},
+   {bool3S::FALSE, bool3S::FALSE, bool3S::FALSE},
+   {bool3S::UNDEF, bool3S::FALSE, bool3S::TRUE}};
+// OR 3S
+constexpr bool3S TABELA_OR3S[3][3] =
+  {{bool3S::UNDEF, bool3S::UNDEF, bool3S::TRUE},
+   {bool3S::UNDEF, bool3S::FALSE, bool3S::TRUE},
+   {bool3S::TRUE,  bool3S::TRUE,  bool3S::TRUE}};
+// XOR 3S
+constexpr bool3S TABELA_XOR3S[3][3] =
+  {{bool3S::UNDEF, bool3S::UNDEF, bool3S::UNDEF},
+   {bool3S::UNDEF, bool3S::FALSE, bool3S::TRUE},
+   {bool3S::UNDEF, bool3S::TRUE,  bool3S::FALSE}};
+
 // Os operadores logicos para a classe bool3S
 // Podem ser usados para facilitar a implementacao dos metodos de simulacao de portas logicas
+// Sao implementados por consulta as tabelas, sem desvios, e podem ser avaliados em
+// tempo de compilacao (constexpr)
 
 // NOT 3S
-bool3S operator~(bool3S x);
+constexpr bool3S operator~(bool3S x)
+{
+  return TABELA_NOT3S[int(x)];
+}
 // AND 3S
-bool3S operator&(bool3S x1, bool3S x2);
-void operator&=(bool3S& x1, bool3S x2);
+constexpr bool3S operator&(bool3S x1, bool3S x2)
+{
+  return TABELA_AND3S[int(x1)][int(x2)];
+}
+inline void operator&=(bool3S& x1, bool3S x2)
+{
+  x1 = TABELA_AND3S[int(x1)][int(x2)];
+}
 // OR 3S
-bool3S operator|(bool3S x1, bool3S x2);
-void operator|=(bool3S& x1, bool3S x2);
+constexpr bool3S operator|(bool3S x1, bool3S x2)
+{
+  return TABELA_OR3S[int(x1)][int(x2)];
+}
+inline void operator|=(bool3S& x1, bool3S x2)
+{
+  x1 = TABELA_OR3S[int(x1)][int(x2)];
+}
 // XOR 3S
-bool3S operator^(bool3S x1, bool3S x2);
-void operator^=(bool3S& x1, bool3S x2);
+constexpr bool3S operator^(bool3S x1, bool3S x2)
+{
+  return TABELA_XOR3S[int(x1)][int(x2)];
+}
+inline void operator^=(bool3S& x1, bool3S x2)
+{
+  x1 = TABELA_XOR3S[int(x1)][int(x2)];
+}
+
+// Verificacao das tabelas em tempo de compilacao
+static_assert((bool3S::TRUE & bool3S::UNDEF)==bool3S::UNDEF &&
+              (bool3S::FALSE & bool3S::UNDEF)==bool3S::FALSE &&
+              (bool3S::TRUE | bool3S::UNDEF)==bool3S::TRUE &&
+              (bool3S::FALSE | bool3S::UNDEF)==bool3S::UNDEF &&
+              (bool3S::TRUE ^ bool3S::TRUE)==bool3S::FALSE &&
+              ~bool3S::FALSE==bool3S::TRUE,
+              "tabelas dos operadores bool3S incorretas");
 
 // Os operadores de incremento/decremento para a classe bool3S
 
@@ -0,0 +1,227 @@
+#ifndef _BOOL3S64_H_
+#define _BOOL3S64_H_
+
+#include <cstdint>
+#include "bool3S.h"
+
+// Um tipo de dados (bool3S_64) que representa 64 valores bool3S independentes,
+// para simulacao bit-paralela de 64 vetores de entrada de uma soh vez.
+// Usa a codificacao "dual-rail": para cada posicao k (de 0 a 63)
+// - bit k de t == 1: o k-esimo valor eh bool3S::TRUE
+// - bit k de f == 1: o k-esimo valor eh bool3S::FALSE
+// - ambos os bits iguais a 0: o k-esimo valor eh bool3S::UNDEF
+// (os dois bits nunca sao iguais a 1 ao mesmo tempo)
+struct bool3S_64
+{
+  uint64_t t;
+  uint64_t f;
+};
+
+// Os operadores logicos para a classe bool3S_64
+// Cada operador produz, em cada posicao, exatamente o mesmo resultado
+// que o operador correspondente de bool3S
+
+// NOT 3S: basta trocar os "trilhos"
+inline bool3S_64 operator~(bool3S_64 x)
+{
+  return bool3S_64{x.f, x.t};
+}
+
+// AND 3S: TRUE se ambos TRUE; FALSE se algum FALSE
+inline bool3S_64 operator&(bool3S_64 x1, bool3S_64 x2)
+{
+  return bool3S_64{x1.t & x2.t, x1.f | x2.f};
+}
+inline void operator&=(bool3S_64& x1, bool3S_64 x2)
+{
+  x1 = x1 & x2;
+}
+
+// OR 3S: TRUE se algum TRUE; FALSE se ambos FALSE
+inline bool3S_64 operator|(bool3S_64 x1, bool3S_64 x2)
+{
+  return bool3S_64{x1.t | x2.t, x1.f & x2.f};
+}
+inline void operator|=(bool3S_64& x1, bool3S_64 x2)
+{
+  x1 = x1 | x2;
+}
+
+// XOR 3S: definido somente se ambos definidos
+inline bool3S_64 operator^(bool3S_64 x1, bool3S_64 x2)
+{
+  return bool3S_64{(x1.t & x2.f) | (x1.f & x2.t),
+                   (x1.t & x2.t) | (x1.f & x2.f)};
+}
+inline void operator^=(bool3S_64& x1, bool3S_64 x2)
+{
+  x1 = x1 ^ x2;
+}
+
+// Comparacao (todas as 64 posicoes iguais)
+inline bool operator==(bool3S_64 x1, bool3S_64 x2)
+{
+  return (x1.t==x2.t && x1.f==x2.f);
+}
+inline bool operator!=(bool3S_64 x1, bool3S_64 x2)
+{
+  return !(x1==x2);
+}
+
+// As conversoes entre bool3S_64 e bool3S
+
+// Retorna um bool3S_64 com as 64 posicoes iguais a B
+inline bool3S_64 toBool3S_64(bool3S B)
+{
+  return bool3S_64{(B==bool3S::TRUE ? ~uint64_t(0) : 0),
+                   (B==bool3S::FALSE ? ~uint64_t(0) : 0)};
+}
+
+// Retorna o k-esimo valor (k de 0 a 63) de um bool3S_64
+inline bool3S getBool3S(bool3S_64 x, int k)
+{
+  if ((x.t>>k) & 1) return bool3S::TRUE;
+  if ((x.f>>k) & 1) return bool3S::FALSE;
+  return bool3S::UNDEF;
+}
+
+// Fixa o k-esimo valor (k de 0 a 63) de um bool3S_64
+inline void setBool3S(bool3S_64& x, int k, bool3S B)
+{
+  uint64_t mask = uint64_t(1)<<k;
+  x.t = (B==bool3S::TRUE ? x.t|mask : x.t&~mask);
+  x.f = (B==bool3S::FALSE ? x.f|mask : x.f&~mask);
+}
+
+// Um tipo de dados (bool3S_bloco) que representa um bloco de BOOL3S_BLOCO valores bool3S
+// independentes, na mesma codificacao dual-rail de bool3S_64, para simulacao com
+// instrucoes vetoriais (SIMD). Os dois trilhos ficam separados e alinhados em 64 bytes,
+// de modo que cada trilho pode ser carregado com uma instrucao AVX-512 ou duas AVX2.
+// O k-esimo valor do bloco estah no bit k%64 da palavra k/64 de cada trilho.
+constexpr int PALAVRAS_BLOCO = 8;
+constexpr int BOOL3S_BLOCO = 64*PALAVRAS_BLOCO;
+
+struct alignas(64) bool3S_bloco
+{
+  uint64_t t[PALAVRAS_BLOCO];
+  uint64_t f[PALAVRAS_BLOCO];
+};
+
+// Os operadores logicos para a classe bool3S_bloco
+// Aplicam o operador correspondente de bool3S_64 a cada palavra dos trilhos.
+// Os lacos tem tamanho fixo e sao vetorizados pelo compilador.
+
+// NOT 3S: basta trocar os "trilhos"
+inline bool3S_bloco operator~(const bool3S_bloco& x)
+{
+  bool3S_bloco r;
+  for (int w=0; w<PALAVRAS_BLOCO; ++w)
+  {
+    r.t[w] = x.f[w];
+    r.f[w] = x.t[w];
+  }
+  return r;
+}
+
+// AND 3S
+inline bool3S_bloco operator&(const bool3S_bloco& x1, const bool3S_bloco& x2)
+{
+  bool3S_bloco r;
+  for (int w=0; w<PALAVRAS_BLOCO; ++w)
+  {
+    r.t[w] = x1.t[w] & x2.t[w];
+    r.f[w] = x1.f[w] | x2.f[w];
+  }
+  return r;
+}
+inline void operator&=(bool3S_bloco& x1, const bool3S_bloco& x2)
+{
+  for (int w=0; w<PALAVRAS_BLOCO; ++w)
+  {
+    x1.t[w] &= x2.t[w];
+    x1.f[w] |= x2.f[w];
+  }
+}
+
+// OR 3S
+inline bool3S_bloco operator|(const bool3S_bloco& x1, const bool3S_bloco& x2)
+{
+  bool3S_bloco r;
+  for (int w=0; w<PALAVRAS_BLOCO; ++w)
+  {
+    r.t[w] = x1.t[w] | x2.t[w];
+    r.f[w] = x1.f[w] & x2.f[w];
+  }
+  return r;
+}
+inline void operator|=(bool3S_bloco& x1, const bool3S_bloco& x2)
+{
+  for (int w=0; w<PALAVRAS_BLOCO; ++w)
+  {
+    x1.t[w] |= x2.t[w];
+    x1.f[w] &= x2.f[w];
+  }
+}
+
+// XOR 3S
+inline bool3S_bloco operator^(const bool3S_bloco& x1, const bool3S_bloco& x2)
+{
+  bool3S_bloco r;
+  for (int w=0; w<PALAVRAS_BLOCO; ++w)
+  {
+    r.t[w] = (x1.t[w] & x2.f[w]) | (x1.f[w] & x2.t[w]);
+    r.f[w] = (x1.t[w] & x2.t[w]) | (x1.f[w] & x2.f[w]);
+  }
+  return r;
+}
+inline void operator^=(bool3S_bloco& x1, const bool3S_bloco& x2)
+{
+  for (int w=0; w<PALAVRAS_BLOCO; ++w)
+  {
+    uint64_t t = (x1.t[w] & x2.f[w]) | (x1.f[w] & x2.t[w]);
+    x1.f[w] = (x1.t[w] & x2.t[w]) | (x1.f[w] & x2.f[w]);
+    x1.t[w] = t;
+  }
+}
+
+// Comparacao (todas as posicoes iguais)
+inline bool operator==(const bool3S_bloco& x1, const bool3S_bloco& x2)
+{
+  uint64_t dif = 0;
+  for (int w=0; w<PALAVRAS_BLOCO; ++w) dif |= (x1.t[w] ^ x2.t[w]) | (x1.f[w] ^ x2.f[w]);
+  return (dif==0);
+}
+inline bool operator!=(const bool3S_bloco& x1, const bool3S_bloco& x2)
+{
+  return !(x1==x2);
+}
+
+// Retorna um bool3S_bloco com todas as posicoes iguais a B
+inline bool3S_bloco toBool3S_bloco(bool3S B)
+{
+  bool3S_64 x = toBool3S_64(B);
+  bool3S_bloco b;
+  for (int w=0; w<PALAVRAS_BLOCO; ++w)
+  {
+    b.t[w] = x.t;
+    b.f[w] = x.f;
+  }
+  return b;
+}
+
+// Retorna o k-esimo valor (k de 0 a BOOL3S_BLOCO-1) de um bool3S_bloco
+inline bool3S getBool3S(const bool3S_bloco& x, int k)
+{
+  return getBool3S(bool3S_64{x.t[k/64], x.f[k/64]}, k%64);
+}
+
+// Fixa o k-esimo valor (k de 0 a BOOL3S_BLOCO-1) de um bool3S_bloco
+inline void setBool3S(bool3S_bloco& x, int k, bool3S B)
+{
+  bool3S_64 prov{x.t[k/64], x.f[k/64]};
+  setBool3S(prov, k%64, B);
+  x.t[k/64] = prov.t;
+  x.f[k/64] = prov.f;
+}
+
+#endif // _BOOL3S64_H_
@@ -1,5 +1,9 @@
 #include <fstream>
+#include <algorithm>
 #include "circuito.h"
+#include "tabelaverdade.h"
+#include "arquivomapeado.h"
+#include "leitortexto.h"
 
 using namespace std;
 
@@ -7,6 +11,60 @@ using namespace std;
 /// CLASSE CIRCUITO
 ///
 
+/// ***********************
+/// Estrutura compartilhada (portas e conectividade)
+/// ***********************
+
+// Estrutura com NO saidas e NP portas, todas indefinidas
+Circuito::Estrutura::Estrutura(int NO, int NP):
+  ports(NP, nullptr),
+  arena(),
+  id_in(NP),
+  id_out(NO, 0)
+{
+  arena.alocar(NP);
+}
+
+// Copia: cria na arena da copia as mesmas portas, nas mesmas posicoes
+Circuito::Estrutura::Estrutura(const Estrutura& E):
+  ports(E.ports.size(), nullptr),
+  arena(),
+  id_in(E.id_in),
+  id_out(E.id_out)
+{
+  arena.alocar(int(E.ports.size()));
+  for (int i=0; i<int(E.ports.size()); ++i)
+  {
+    if (E.ports[i]==nullptr) continue;
+    ports[i] = arena.criar(i, E.ports[i]->getTipo(), E.ports[i]->getNumInputs());
+    ports[i]->setOutput(E.ports[i]->getOutput());
+  }
+}
+
+// Destroi as portas
+// As portas nao liberam memoria: a arena eh liberada de uma soh vez, em seguida
+Circuito::Estrutura::~Estrutura()
+{
+  for (auto p : ports) ArenaPortas::destruir(p);
+}
+
+// A estrutura vazia compartilhada por todos os circuitos vazios
+const std::shared_ptr<Circuito::Estrutura>& Circuito::estruturaVazia()
+{
+  static const std::shared_ptr<Estrutura> vazia = std::make_shared<Estrutura>();
+  return vazia;
+}
+
+// Retorna a estrutura para ser alterada, duplicando-a se for compartilhada
+Circuito::Estrutura& Circuito::alterarEstrutura()
+{
+  if (estr.use_count()>1) estr = std::make_shared<Estrutura>(*estr);
+  // O circuito vai mudar: a representacao compilada e a validade devem ser refeitas
+  comp.reset();
+  validade_atualizada = false;
+  return *estr;
+}
+
 /// ***********************
 /// Inicializacao e finalizacao
 /// ***********************
@@ -17,25 +75,26 @@ using namespace std;
 //
 Circuito::Circuito(const Circuito& C):
     Nin_circ(C.Nin_circ),
-    ports(),
+    estr(C.estr),
     out_circ(C.out_circ),
-    id_in(C.id_in),
-    id_out(C.id_out)
+    comp(C.comp),
+    validade_atualizada(C.validade_atualizada),
+    valido(C.valido)
 {
-    for (auto p : C.ports) this->ports.push_back(p->clone());
 }
 
 // Construtor por movimento
 //
 //  IMPLEMENTEI
 //
-Circuito::Circuito(Circuito&& C) noexcept
+Circuito::Circuito(Circuito&& C) noexcept: Circuito()
 {
     swap(Nin_circ, C.Nin_circ);
-    swap(ports, C.ports);
+    swap(estr, C.estr);
     swap(out_circ, C.out_circ);
-    swap(id_in, C.id_in);
-    swap(id_out, C.id_out);
+    swap(comp, C.comp);
+    swap(validade_atualizada, C.validade_atualizada);
+    swap(valido, C.valido);
 }
 
 // Limpa todo o conteudo do circuito.
@@ -45,11 +104,11 @@ void Circuito::clear() noexcept
   //  IMPLEMENTEI
   //
     Nin_circ = 0;
-    for (auto p: this->ports) delete p;
-    ports.clear();
+    // A estrutura soh eh destruida se nao for compartilhada com outro circuito
+    estr = estruturaVazia();
     out_circ.clear();
-    id_in.clear();
-    id_out.clear();
+    comp.reset();
+    validade_atualizada = false;
 }
 
 // Operador de atribuicao por copia
@@ -60,13 +119,12 @@ Circuito& Circuito::operator=(const Circuito& C)
     //
     if (this==&C) return *this;
 
-    clear();
-
     Nin_circ = C.Nin_circ;
-    for (const auto& p : C.ports) this->ports.push_back(p->clone());
+    estr = C.estr;
     out_circ = C.out_circ;
-    id_in = C.id_in;
-    id_out = C.id_out;
+    comp = C.comp;
+    validade_atualizada = C.validade_atualizada;
+    valido = C.valido;
     return *this;
 }
 
@@ -81,10 +139,11 @@ Circuito& Circuito::operator=(Circuito&& C) noexcept
     clear();
 
     swap(Nin_circ, C.Nin_circ);
-    swap(ports, C.ports);
+    swap(estr, C.estr);
     swap(out_circ, C.out_circ);
-    swap(id_in, C.id_in);
-    swap(id_out, C.id_out);
+    swap(comp, C.comp);
+    swap(validade_atualizada, C.validade_atualizada);
+    swap(valido, C.valido);
     return *this;
 }
 
@@ -99,10 +158,8 @@ void Circuito::resize(int NI, int NO, int NP)
   clear();
 
   Nin_circ = NI;
+  estr = std::make_shared<Estrutura>(NO, NP);
   out_circ.resize(NO);
-  id_in.resize(NP);
-  id_out.resize(NO);
-  for (int i=0; i<NP; ++i) id_in.at(i).resize(NP);
 }
 
 /// ***********************
@@ -112,6 +169,9 @@ void Circuito::resize(int NI, int NO, int NP)
 // Testa igualdade entre circuitos
 bool Circuito::operator==(const Circuito& C) const
 {
+  // Circuitos que compartilham a mesma estrutura sao iguais
+  if (estr==C.estr && getNumInputs()==C.getNumInputs()) return true;
+
   // Testa a igualdade do numero de entradas, saidas e portas
   if (getNumInputs() != C.getNumInputs() ||
       getNumOutputs() != C.getNumOutputs() ||
@@ -142,8 +202,8 @@ bool Circuito::operator==(const Circuito& C) const
   return true;
 }
 
-// Testa circuito valido
-bool Circuito::valid() const
+// Testa circuito valido (percorre todo o circuito)
+bool Circuito::testarValidade() const
 {
   int id;
   // Testa o numero de entradas, saidas e portas
@@ -166,6 +226,30 @@ bool Circuito::valid() const
   return true;
 }
 
+// Testa se o circuito tem lacos combinacionais
+bool Circuito::possuiCiclo()
+{
+  if (!valid()) return false;
+  compilar();
+  return comp->possuiCiclo();
+}
+
+// Retorna as ids das portas de cada laco combinacional
+std::vector< std::vector<int> > Circuito::getLacos()
+{
+  std::vector< std::vector<int> > lacos;
+  if (!valid()) return lacos;
+  compilar();
+
+  lacos.resize(comp->getNumLacos());
+  for (int c=0; c<comp->getNumLacos(); ++c)
+  {
+    lacos[c] = comp->getPortasLaco(c);
+    for (int& id : lacos[c]) ++id;
+  }
+  return lacos;
+}
+
 /// ***********************
 /// Funcoes de modificacao
 /// ***********************
@@ -182,21 +266,18 @@ bool Circuito::setPort(int IdPort, std::string& Tipo, int Nin)
   if (Tipo.size()!=2) return false;
   Tipo.at(0) = toupper(Tipo.at(0));
   Tipo.at(1) = toupper(Tipo.at(1));
-  if (Tipo!="NT" &&
-      Tipo!="AN" && Tipo!="NA" &&
-      Tipo!="OR" && Tipo!="NO" &&
-      Tipo!="XO" && Tipo!="NX") return false;
-  if (Tipo=="NT" && Nin!=1) return false;
-  if (Tipo!="NT" && Nin<2) return false;
-
-  // Altera a porta:
-  // - cria a nova porta
-  // - redimensiona o vetor de conexoes da porta
-
-  //
-  // FALTA IMPLEMENTAR
-  //
+  TipoPorta T;
+  if (!tipoPorta(Tipo, T)) return false;
+  if (T==TipoPorta::NT && Nin!=1) return false;
+  if (T!=TipoPorta::NT && Nin<2) return false;
 
+  // Altera a porta (em uma estrutura que nao seja compartilhada):
+  // - destroi a porta anterior e cria a nova na mesma posicao da arena
+  // - redimensiona o vetor de conexoes da porta
+  Estrutura& E = alterarEstrutura();
+  ArenaPortas::destruir(E.ports.at(IdPort-1));
+  E.ports.at(IdPort-1) = E.arena.criar(IdPort-1, T, Nin);
+  E.id_in.setNumInputs(IdPort-1, Nin);
   return true;
 }
 
@@ -205,10 +286,10 @@ bool Circuito::setIdInPort(int IdPort, int I, int IdOrig)
 {
   // Chegagem dos parametros
   if (!definedPort(IdPort)) return false;
-  if (!ports.at(IdPort-1)->validIndex(I)) return false;
+  if (!estr->ports.at(IdPort-1)->validIndex(I)) return false;
   if (!validIdOrig(IdOrig)) return false;
-  // Fixa a origem da entrada
-  id_in.at(IdPort-1).at(I) = IdOrig;
+  // Fixa a origem da entrada (em uma estrutura que nao seja compartilhada)
+  alterarEstrutura().id_in[IdPort-1][I] = IdOrig;
   return true;
 }
 
@@ -216,7 +297,39 @@ bool Circuito::setIdInPort(int IdPort, int I, int IdOrig)
 bool Circuito::setIdOutputCirc(int IdOut, int IdOrig)
 {
   if (!validIdOutputCirc(IdOut) || !validIdOrig(IdOrig)) return false;
-  id_out.at(IdOut-1) = IdOrig;
+  alterarEstrutura().id_out.at(IdOut-1) = IdOrig;
+  return true;
+}
+
+// Substitui o circuito por um circuito montado diretamente a partir de vetores CSR
+bool Circuito::montar(int NI, const std::vector<TipoPorta>& tipo, const std::vector<int>& iniIn,
+                      const std::vector<int>& idIn, const std::vector<int>& idOut)
+{
+  const int NP = int(tipo.size());
+  const int NO = int(idOut.size());
+  if (NI<=0 || NO<=0 || NP<=0 || int(iniIn.size())!=NP+1 || iniIn[0]!=0 ||
+      iniIn[NP]!=int(idIn.size())) return false;
+
+  Circuito prov(NI, NO, NP);
+  Estrutura& E = *prov.estr;
+  for (int i=0; i<NP; ++i)
+  {
+    int Nin_port = iniIn[i+1]-iniIn[i];
+    if (tipo[i]==TipoPorta::NT ? Nin_port!=1 : Nin_port<2) return false;
+    E.ports[i] = E.arena.criar(i, tipo[i], Nin_port);
+  }
+  for (int id_orig : idIn)
+  {
+    if (!prov.validIdOrig(id_orig)) return false;
+  }
+  E.id_in.atribuir(iniIn, idIn);
+  for (int j=0; j<NO; ++j)
+  {
+    if (!prov.validIdOrig(idOut[j])) return false;
+    E.id_out[j] = idOut[j];
+  }
+
+  *this = std::move(prov);
   return true;
 }
 
@@ -307,6 +420,94 @@ bool Circuito::ler(const std::string& arq)
   return true;
 }
 
+// Entrada rapida dos dados de um circuito via arquivo
+bool Circuito::lerRapido(const std::string& arq, ErroLeitura* erro)
+{
+  ArquivoMapeado A;
+  if (!A.abrir(arq))
+  {
+    if (erro!=nullptr) *erro = ErroLeitura{0, 0, "nao foi possivel abrir o arquivo " + arq};
+    return false;
+  }
+  LeitorTexto L(A.getDados(), A.getTamanho());
+  // Registra o erro na posicao do ultimo elemento lido e retorna false
+  auto falha = [&L, erro](const std::string& msg)
+  {
+    if (erro!=nullptr) L.erro(*erro, msg);
+    return false;
+  };
+
+  // Variaveis temporarias para leitura
+  int NI,NO,NP;
+  std::string Tipo;
+  TipoPorta T;
+  int Nin_port;
+  int id_orig;
+  int i,id,I;
+
+  // Lendo as dimensoes do circuito
+  if (!L.lerPalavra("CIRCUITO")) return falha("esperado CIRCUITO");
+  if (!L.lerInteiro(NI) || NI<=0) return falha("numero de entradas invalido");
+  if (!L.lerInteiro(NO) || NO<=0) return falha("numero de saidas invalido");
+  if (!L.lerInteiro(NP) || NP<=0) return falha("numero de portas invalido");
+
+  // O novo circuito provisorio, cuja estrutura (que nao eh compartilhada) eh preenchida
+  // diretamente, sem as verificacoes de setPort, setIdInPort e setIdOutputCirc
+  Circuito prov(NI, NO, NP);
+  Estrutura& E = *prov.estr;
+
+  // Lendo as portas do circuito
+  if (!L.lerPalavra("PORTAS")) return falha("esperado PORTAS");
+  for (i=0; i<NP; ++i)
+  {
+    // Lendo o tipo e o numero de entradas de uma porta
+    if (!L.lerInteiro(id) || id != i+1) return falha("esperada a porta " + to_string(i+1));
+    if (!L.lerCaractere(')')) return falha("esperado )");
+    if (!L.lerPalavra(Tipo) || Tipo.size()!=2) return falha("tipo de porta invalido");
+    Tipo[0] = toupper(Tipo[0]);
+    Tipo[1] = toupper(Tipo[1]);
+    if (!tipoPorta(Tipo, T)) return falha("tipo de porta invalido");
+    if (!L.lerInteiro(Nin_port) || (T==TipoPorta::NT ? Nin_port!=1 : Nin_port<2))
+      return falha("numero de entradas da porta invalido");
+    E.ports[i] = E.arena.criar(i, T, Nin_port);
+    E.id_in.setNumInputs(i, Nin_port);
+  }
+
+  // Lendo a conectividade das portas
+  if (!L.lerPalavra("CONEXOES")) return falha("esperado CONEXOES");
+  for (i=0; i<NP; ++i)
+  {
+    // Lendo a id da porta
+    if (!L.lerInteiro(id) || id != i+1) return falha("esperada a porta " + to_string(i+1));
+    if (!L.lerCaractere(')')) return falha("esperado )");
+    // Lendo as ids das entradas da porta
+    for (I=0; I<E.id_in.getNumInputs(i); ++I)
+    {
+      if (!L.lerInteiro(id_orig) || !prov.validIdOrig(id_orig))
+        return falha("origem invalida para a entrada " + to_string(I+1) + " da porta " +
+                     to_string(id));
+      E.id_in[i][I] = id_orig;
+    }
+  }
+
+  // Lendo as saidas do circuito
+  if (!L.lerPalavra("SAIDAS")) return falha("esperado SAIDAS");
+  for (i=0; i<NO; ++i)
+  {
+    // Lendo a id de uma saida do circuito
+    if (!L.lerInteiro(id) || id != i+1) return falha("esperada a saida " + to_string(i+1));
+    if (!L.lerCaractere(')')) return falha("esperado )");
+    if (!L.lerInteiro(id_orig) || !prov.validIdOrig(id_orig))
+      return falha("origem invalida para a saida " + to_string(id));
+    E.id_out[i] = id_orig;
+  }
+
+  // Leitura OK
+  // Faz o circuito assumir as caracteristicas lidas do arquivo
+  *this = std::move(prov);
+  return true;
+}
+
 // Saida dos dados de um circuito
 std::ostream& Circuito::escrever(std::ostream& O) const
 {
@@ -354,63 +555,282 @@ bool Circuito::salvar(const std::string& arq) const
   return true;
 }
 
+// Salvar circuito em arquivo binario
+bool Circuito::salvarBinario(const std::string& arq) const
+{
+  if (!valid()) return false;
+
+  // Usa a representacao compilada atual ou, se ela estiver desatualizada, uma provisoria
+  if (comp!=nullptr) return comp->salvarBinario(arq);
+  CircuitoCompilado CC;
+  CC.compilar(Nin_circ, estr->ports, estr->id_in, estr->id_out);
+  return CC.salvarBinario(arq);
+}
+
+// Entrada dos dados de um circuito via arquivo binario
+bool Circuito::lerBinario(const std::string& arq)
+{
+  auto CC = std::make_shared<CircuitoCompilado>();
+  if (!CC->lerBinario(arq)) return false;
+
+  // O novo circuito, com as portas e as conexoes da representacao compilada
+  Circuito prov(CC->getNumInputs(), CC->getNumOutputs(), CC->getNumPorts());
+  Estrutura& E = *prov.estr;
+  for (int i=0; i<CC->getNumPorts(); ++i)
+  {
+    int Nin_port = CC->getNumInputsPort(i);
+    E.ports[i] = E.arena.criar(i, CC->getTipoPort(i), Nin_port);
+    E.id_in.setNumInputs(i, Nin_port);
+    for (int I=0; I<Nin_port; ++I) E.id_in[i][I] = CC->idOrig(CC->getSinalInPort(i, I));
+  }
+  for (int j=0; j<CC->getNumOutputs(); ++j) E.id_out[j] = CC->idOrig(CC->getSinalOutCirc(j));
+  prov.comp = CC;
+
+  *this = std::move(prov);
+  return true;
+}
+
 /// ***********************
 /// SIMULACAO (funcao principal do circuito)
 /// ***********************
 
+// Monta a representacao compilada, se ela estiver desatualizada
+void Circuito::compilar()
+{
+  if (comp!=nullptr) return;
+  comp = std::make_shared<CircuitoCompilado>();
+  comp->compilar(Nin_circ, estr->ports, estr->id_in, estr->id_out);
+}
+
+// Retorna a representacao compilada, exclusiva deste circuito, para uma simulacao
+CircuitoCompilado& Circuito::compiladoExclusivo()
+{
+  compilar();
+  if (comp.use_count()>1) comp = std::make_shared<CircuitoCompilado>(*comp);
+  return *comp;
+}
+
 // Simula o circuito
 bool Circuito::simular(const std::vector<bool3S>& in_circ)
 {
-    // Verifica se o circuito e o parâmetro são válidos
-    if (!valid() || int(in_circ.size()) != getNumInputs()) return false;
+  // Verifica se o circuito e o parametro sao validos
+  // (a validade, assim como a representacao compilada, soh eh refeita se o circuito foi alterado)
+  if (!valid() || int(in_circ.size()) != getNumInputs()) return false;
+
+  CircuitoCompilado& CC = compiladoExclusivo();
+  CC.simular(in_circ.data());
+
+  // Copia as saidas do circuito
+  for (int i=0; i<getNumOutputs(); ++i) out_circ[i] = CC.getOutputCirc(i);
+
+  // Simulacao concluida com sucesso
+  return true;
+}
+
+// Simula o circuito reavaliando apenas as portas afetadas pelas entradas que mudaram
+bool Circuito::simularEventos(const std::vector<bool3S>& in_circ)
+{
+  if (!valid() || int(in_circ.size()) != getNumInputs()) return false;
+
+  CircuitoCompilado& CC = compiladoExclusivo();
+  CC.simularEventos(in_circ.data());
+
+  for (int i=0; i<getNumOutputs(); ++i) out_circ[i] = CC.getOutputCirc(i);
+  return true;
+}
+
+// Simula o circuito para 64 vetores de entrada simultaneos
+bool Circuito::simular64(const std::vector<bool3S_64>& in_circ)
+{
+  if (!valid() || int(in_circ.size()) != getNumInputs()) return false;
+
+  compiladoExclusivo().simular64(in_circ.data());
+  return true;
+}
+
+// Simula o circuito para BOOL3S_BLOCO vetores de entrada simultaneos
+bool Circuito::simularBloco(const std::vector<bool3S_bloco>& in_circ, KernelPorta K)
+{
+  if (!valid() || int(in_circ.size()) != getNumInputs()) return false;
+
+  compiladoExclusivo().simularBloco(in_circ.data(), K);
+  return true;
+}
+
+/// ***********************
+/// CONES DE INFLUENCIA
+/// ***********************
+
+// Retorna o cone de influencia de algumas saidas
+std::shared_ptr<const ConeInfluencia> Circuito::cone(const std::vector<int>& IdOutputs)
+{
+  if (!valid() || IdOutputs.empty()) return nullptr;
+
+  std::vector<int> saidas;
+  for (int id : IdOutputs)
+  {
+    if (!validIdOutputCirc(id)) return nullptr;
+    saidas.push_back(id-1);
+  }
+  return compiladoExclusivo().getCone(saidas);
+}
+
+// Simula apenas o cone de influencia de algumas saidas
+bool Circuito::simularSaidas(const std::vector<int>& IdOutputs, const std::vector<bool3S>& in_circ)
+{
+  if (int(in_circ.size()) != getNumInputs()) return false;
+  std::shared_ptr<const ConeInfluencia> K = cone(IdOutputs);
+  if (K==nullptr) return false;
+
+  comp->simularCone(*K, in_circ.data());
+
+  // Soh as saidas pedidas foram calculadas
+  for (int i=0; i<getNumOutputs(); ++i) out_circ[i] = bool3S::UNDEF;
+  for (int id : IdOutputs) out_circ[id-1] = comp->getOutputCirc(id-1);
+  return true;
+}
+
+// Ids das entradas das quais algumas saidas dependem
+std::vector<int> Circuito::getEntradasCone(const std::vector<int>& IdOutputs)
+{
+  std::vector<int> ids;
+  std::shared_ptr<const ConeInfluencia> K = cone(IdOutputs);
+  if (K==nullptr) return ids;
+
+  for (int i : K->entradas) ids.push_back(-(i+1));
+  return ids;
+}
+
+/// ***********************
+/// TABELA VERDADE
+/// ***********************
+
+// Gera todas as linhas da tabela verdade, uma a uma
+bool Circuito::gerarTabela(const ReceptorLinha& receptor, OrdemTabela ordem)
+{
+  if (!valid() || numLinhasTabela(getNumInputs())<0) return false;
+  CircuitoCompilado& CC = compiladoExclusivo();
+
+  std::vector<bool3S> out(getNumOutputs());
+  int i;
+
+  // Linhas consecutivas diferem em poucas entradas (uma soh no codigo de Gray):
+  // a simulacao dirigida por eventos soh reavalia as portas afetadas
+  if (ordem==OrdemTabela::GRAY)
+  {
+    GeradorGray gerador(getNumInputs());
+    do
+    {
+      CC.simularEventos(gerador.getEntradas().data());
+      for (i=0; i<getNumOutputs(); ++i) out[i] = CC.getOutputCirc(i);
+      if (!receptor(gerador.getLinha(), gerador.getEntradas().data(), out.data())) return false;
+    } while (gerador.proximo());
+  }
+  else
+  {
+    std::vector<bool3S> in(getNumInputs(), bool3S::UNDEF);
+    long long linha = 0;
+    do
+    {
+      CC.simularEventos(in.data());
+      for (i=0; i<getNumOutputs(); ++i) out[i] = CC.getOutputCirc(i);
+      if (!receptor(linha++, in.data(), out.data())) return false;
+    } while (proximaLinha(in));
+  }
+  return true;
+}
+
+// Gera as linhas da tabela verdade em paralelo
+bool Circuito::gerarTabela(const ReceptorLinha& receptor, PoolTrabalho& P)
+{
+  if (!valid()) return false;
+  compilar();
 
-    bool todasDefinidas, algumaAtualizada;
-    int idOrigem;
+  std::vector<bool3S> in(getNumInputs());
+  int NO = getNumOutputs();
 
-    // Inicializa as saídas das portas como indefinidas
-    for (auto& porta : ports) {
-        porta->setOutput(bool3S::UNDEF);
+  return gerarTabelaParalela(*comp, P, [&](long long primeira, int Nlinhas, const bool3S* saidas)
+  {
+    linhaParaEntradas(primeira, in);
+    for (int l=0; l<Nlinhas; ++l)
+    {
+      if (!receptor(primeira+l, in.data(), saidas+size_t(l)*NO)) return false;
+      proximaLinha(in);
     }
+    return true;
+  });
+}
 
-    do {
-        todasDefinidas = true;
-        algumaAtualizada = false;
-
-        // Itera por todas as portas do circuito
-        for (int idPorta = 0; idPorta < getNumPorts(); ++idPorta) {
-            if (ports[idPorta]->getOutput() == bool3S::UNDEF) {
-                std::vector<bool3S> entradasPorta(getNumInputsPort(idPorta));
-
-                // Coleta os valores das entradas da porta
-                for (int i = 0; i < getNumInputsPort(idPorta); ++i) {
-                    idOrigem = getIdInPort(idPorta, i);
-
-                    entradasPorta[i] = (idOrigem > 0)
-                                           ? ports[idOrigem - 1]->getOutput()  // Saída de outra porta
-                                           : in_circ[-idOrigem - 1];           // Entrada do circuito
-                }
-
-                // Simula a porta com as entradas coletadas
-                ports[idPorta]->simular(entradasPorta);
-
-                if (ports[idPorta]->getOutput() == bool3S::UNDEF) {
-                    todasDefinidas = false;
-                } else {
-                    algumaAtualizada = true;
-                }
-            }
-        }
-    } while (!todasDefinidas && algumaAtualizada);
-
-    // Calcula as saídas do circuito
-    for (int idSaida = 0; idSaida < getNumOutputs(); ++idSaida) {
-        idOrigem = id_out[idSaida];
-        out_circ[idSaida] = (idOrigem > 0)
-                                ? ports[idOrigem - 1]->getOutput()  // Saída de uma porta
-                                : in_circ[-idOrigem - 1];            // Entrada do circuito
+// Gera todas as linhas da tabela verdade binaria, 64 de cada vez
+bool Circuito::gerarTabelaBinaria(const ReceptorLinha& receptor)
+{
+  if (!valid()) return false;
+  CircuitoCompilado& CC = compiladoExclusivo();
+
+  const int NI = getNumInputs();
+  const int NO = getNumOutputs();
+  // Com mais de 62 entradas, 2^NI linhas nao cabem em um long long
+  if (NI>MAX_ENTRADAS_BINARIA) return false;
+  const long long total = numLinhasTabelaBinaria(NI);
+  std::vector<uint64_t> in64(NI);
+  std::vector<bool3S_64> in3(CC.possuiCiclo() ? NI : 0);
+  std::vector<bool3S_64> saidas(NO);
+  std::vector<bool3S> in(NI), out(NO);
+  int i, l;
+
+  for (long long base=0; base<total; base+=64)
+  {
+    linhasBinariasParaEntradas(base, in64);
+    if (CC.possuiCiclo())
+    {
+      // Simulacao ternaria: os lacos podem resultar em UNDEF
+      for (i=0; i<NI; ++i) in3[i] = bool3S_64{in64[i], ~in64[i]};
+      CC.simular64(in3.data());
+      for (i=0; i<NO; ++i) saidas[i] = CC.getOutputCirc64(i);
+    }
+    else
+    {
+      CC.simularBinario(in64.data());
+      for (i=0; i<NO; ++i)
+      {
+        uint64_t b = CC.getOutputCircBinario(i);
+        saidas[i] = bool3S_64{b, ~b};
+      }
     }
 
-    // Simulação concluída com sucesso
-    return true;
+    // Entrega as linhas do bloco
+    int Nlinhas = int(std::min(64LL, total-base));
+    for (l=0; l<Nlinhas; ++l)
+    {
+      for (i=0; i<NI; ++i) in[i] = (((in64[i] >> l) & 1) ? bool3S::TRUE : bool3S::FALSE);
+      for (i=0; i<NO; ++i) out[i] = getBool3S(saidas[i], l);
+      if (!receptor(base+l, in.data(), out.data())) return false;
+    }
+  }
+  return true;
 }
 
+// Gera a tabela verdade de algumas saidas, enumerando apenas as entradas do seu cone
+bool Circuito::gerarTabela(const std::vector<int>& IdOutputs, const ReceptorLinha& receptor)
+{
+  std::shared_ptr<const ConeInfluencia> K = cone(IdOutputs);
+  if (K==nullptr || numLinhasTabela(int(K->entradas.size()))<0) return false;
+  CircuitoCompilado& CC = *comp;
+
+  // Entradas do circuito completo (as que nao estao no cone ficam UNDEF e nao sao lidas)
+  // e as k entradas do cone, que sao as enumeradas
+  std::vector<bool3S> in_circ(getNumInputs(), bool3S::UNDEF);
+  std::vector<bool3S> in(K->entradas.size(), bool3S::UNDEF);
+  std::vector<bool3S> out(IdOutputs.size());
+  long long linha = 0;
+  size_t j;
+
+  do
+  {
+    for (j=0; j<in.size(); ++j) in_circ[K->entradas[j]] = in[j];
+    CC.simularCone(*K, in_circ.data());
+    for (j=0; j<IdOutputs.size(); ++j) out[j] = CC.getOutputCirc(IdOutputs[j]-1);
+    if (!receptor(linha++, in.data(), out.data())) return false;
+  } while (proximaLinha(in));
+  return true;
+}
@@ -1,8 +1,12 @@
 #ifndef _CIRCUITO_H_
 #define _CIRCUITO_H_
 
+#include <functional>
+#include <memory>
 #include "bool3S.h"
 #include "porta.h"
+#include "arenaportas.h"
+#include "circuitocompilado.h"
 
 /// ###########################################################################
 /// ATENCAO PARA A CONVENCAO DOS NOMES PARA OS PARAMETROS DAS FUNCOES:
@@ -15,6 +19,26 @@
 ///       (id da origem de uma entrada de porta ou de uma saida do circuito)
 /// ###########################################################################
 
+class PoolTrabalho;
+struct ErroLeitura;
+
+// Ordem em que as linhas da tabela verdade sao geradas (Circuito::gerarTabela)
+// - CANONICA: entradas vistas como um numero na base 3 (UNDEF=0, FALSE=1, TRUE=2),
+//   de todas UNDEF ateh todas TRUE
+// - GRAY: codigo de Gray ternario (cada linha difere da anterior em uma unica entrada),
+//   que eh a ordem mais rapida de simular
+enum class OrdemTabela
+{
+  CANONICA,
+  GRAY
+};
+
+// Funcao que recebe uma linha da tabela verdade: o numero da linha na ordem canonica
+// (de 0 a 3^NI-1), os valores das NI entradas e das NO saidas do circuito.
+// Os vetores soh sao validos durante a chamada.
+// Se retornar false, a geracao da tabela eh interrompida.
+using ReceptorLinha = std::function<bool(long long linha, const bool3S* in, const bool3S* out)>;
+
 ///
 /// CLASSE CIRCUITO
 ///
@@ -26,35 +50,113 @@ private:
   /// Dados
   /// ***********************
 
+  // ESTRUTURA DO CIRCUITO: PORTAS E CONECTIVIDADE
+  // Fica em um objeto separado, compartilhado (com contagem de referencias) entre as
+  // copias de um circuito: copiar um circuito nao duplica as portas nem as conexoes.
+  // A estrutura soh eh duplicada quando um circuito que a compartilha com outros eh
+  // alterado (setPort, setIdInPort e setIdOutputCirc): "copy-on-write".
+  struct Estrutura
+  {
+    // PORTAS DO CIRCUITO
+    // ports.at(i) aponta para a porta cuja id=i+1 (nullptr se ela estiver indefinida).
+    // As portas ficam armazenadas de forma contigua na arena, na posicao i.
+    std::vector<ptr_Porta> ports;
+    ArenaPortas arena;
+
+    // CONECTIVIDADE DO CIRCUITO
+
+    // As ids das origens das entradas das portas
+    // Ficam em vetores contiguos (ConexoesPortas), com dimensao "Nports": id_in[i] aponta
+    // para as origens das entradas da porta cuja id=i+1, que sao tantas quanto as entradas
+    // dessa porta (id_in.getNumInputs(i))
+    // se id_in[i][j]>0: a j-esima entrada da i-esima porta (id=i+1) vem da saida da porta
+    // cuja id eh o valor desse elemento do array
+    // se id_in[i][j]<0: a j-esima entrada da i-esima porta (id=i+1) vem da entrada do circuito
+    // cuja id eh o valor desse elemento do array
+    // se id_in[i][j]==0: a j-esima entrada da i-esima porta (id=i+1) estah indefinida
+    ConexoesPortas id_in;
+
+    // As ids das origens dos sinais de saida do circuito
+    // Deve ser um vetor com dimensao "Nout"
+    // se id_out.at(i)>0: a i-esima saida do circuito (id=i+1) vem da saida da porta
+    // cuja id eh o valor desse elemento do array
+    // se id_out.at(i)<0: a i-esima saida do circuito (id=i+1) vem da entrada do circuito
+    // cuja id eh o valor desse elemento do array
+    // se id_out.at(i)==0: a i-esima saida do circuito (id=i+1) estah indefinida
+    std::vector<int> id_out;
+
+    // Estrutura vazia
+    Estrutura(): ports(), arena(), id_in(), id_out() {}
+    // Estrutura com NO saidas e NP portas, todas indefinidas
+    Estrutura(int NO, int NP);
+    // Copia (as portas sao recriadas na arena da copia, nas mesmas posicoes)
+    Estrutura(const Estrutura& E);
+    // Destroi as portas
+    ~Estrutura();
+
+    Estrutura& operator=(const Estrutura&) = delete;
+  };
+
+  /// ***********************
+  /// Dados
+  /// ***********************
+
   // NUMERO DE ENTRADAS DO CIRCUITO
   int Nin_circ;
 
-  // PORTAS DO CIRCUITO
-  std::vector<ptr_Porta> ports;
+  // PORTAS E CONECTIVIDADE DO CIRCUITO (possivelmente compartilhadas com copias)
+  // Nunca eh nullptr: os circuitos vazios compartilham uma mesma estrutura vazia.
+  std::shared_ptr<Estrutura> estr;
 
   // VALORES DAS SAIDAS LOGICAS DO CIRCUITO
   std::vector<bool3S> out_circ;
 
-  // CONECTIVIDADE DO CIRCUITO
-
-  // As ids das origens das entradas das portas
-  // Eh um vetor de vetores: o vetor principal deve ter dimensao "Nports"
-  // Cada vetor id_in.at(i) deve ter dimensao igual ao numero de entradas da porta cuja id=i+1
-  // se id_in.at(i).at(j)>0: a j-esima entrada da i-esima porta (id=i+1) vem da saida da porta
-  // cuja id eh o valor desse elemento do array
-  // se id_in.at(i).at(j)<0: a j-esima entrada da i-esima porta (id=i+1) vem da entrada do circuito
-  // cuja id eh o valor desse elemento do array
-  // se id_in.at(i).at(j)==0: a j-esima entrada da i-esima porta (id=i+1) estah indefinida
-  std::vector< std::vector<int> > id_in;
-
-  // As ids das origens dos sinais de saida do circuito
-  // Deve ser um vetor com dimensao "Nout"
-  // se id_out.at(i)>0: a i-esima saida do circuito (id=i+1) vem da saida da porta
-  // cuja id eh o valor desse elemento do array
-  // se id_out.at(i)<0: a i-esima saida do circuito (id=i+1) vem da entrada do circuito
-  // cuja id eh o valor desse elemento do array
-  // se id_out.at(i)==0: a i-esima saida do circuito (id=i+1) estah indefinida
-  std::vector<int> id_out;
+  // REPRESENTACAO COMPILADA DO CIRCUITO
+
+  // Copia da conectividade em vetores contiguos, com as portas em ordem topologica,
+  // usada pela simulacao. Tambem armazena os valores logicos atuais de todos os sinais.
+  // Eh montada uma unica vez e reaproveitada em todas as simulacoes
+  // ateh que o circuito seja alterado (quando passa a ser nullptr).
+  // Tambem eh compartilhada entre as copias do circuito; soh eh duplicada quando uma
+  // copia que a compartilha faz uma simulacao (que altera os valores dos sinais).
+  std::shared_ptr<CircuitoCompilado> comp;
+
+  // VALIDADE DO CIRCUITO
+  // O resultado de valid() eh guardado e soh eh recalculado depois que o circuito
+  // for alterado (resize, setPort, setIdInPort, setIdOutputCirc, ler e clear).
+  // true se "valido" estah atualizado em relacao ao circuito
+  mutable bool validade_atualizada;
+  // Resultado do ultimo teste de validade
+  mutable bool valido;
+
+  /// ***********************
+  /// Funcoes auxiliares
+  /// ***********************
+
+  // A estrutura vazia compartilhada por todos os circuitos vazios
+  static const std::shared_ptr<Estrutura>& estruturaVazia();
+
+  // Retorna a estrutura do circuito para ser alterada,
+  // duplicando-a antes se ela for compartilhada com outro circuito.
+  // Tambem descarta a representacao compilada e a validade, que deixam de estar atualizadas.
+  Estrutura& alterarEstrutura();
+
+  // Testa se o circuito eh valido, percorrendo todas as portas e conexoes
+  // (valid() soh chama esta funcao se o circuito foi alterado desde o ultimo teste)
+  bool testarValidade() const;
+
+  // Monta a representacao compilada, se ela estiver desatualizada.
+  // Soh deve ser chamada para circuitos validos.
+  void compilar();
+
+  // Retorna a representacao compilada para ser usada em uma simulacao, montando-a
+  // se necessario e duplicando-a antes se ela for compartilhada com outro circuito.
+  // Soh deve ser chamada para circuitos validos.
+  CircuitoCompilado& compiladoExclusivo();
+
+  // Retorna o cone de influencia das saidas cujas ids estao em IdOutputs
+  // ou nullptr se o circuito ou alguma id forem invalidos (ou se IdOutputs for vazio).
+  std::shared_ptr<const ConeInfluencia> cone(const std::vector<int>& IdOutputs);
 
 public:
 
@@ -65,10 +167,11 @@ public:
   // Construtor default = circuito vazio
   Circuito():
     Nin_circ(0),
-    ports(),
+    estr(estruturaVazia()),
     out_circ(),
-    id_in(),
-    id_out()
+    comp(),
+    validade_atualizada(false),
+    valido(false)
   {}
 
   // Cria o circuito com NI entradas, NO saidas e NP portas,
@@ -77,7 +180,8 @@ public:
     resize(NI,NO,NP);
   }
 
-  // Construtor por copia
+  // Construtor por copia.
+  // Nao duplica as portas nem as conexoes, que passam a ser compartilhadas: O(1).
   Circuito(const Circuito& C);
   // Construtor por movimento
   Circuito(Circuito&& C) noexcept;
@@ -90,7 +194,7 @@ public:
   // Limpa todo o conteudo do circuito.
   void clear() noexcept;
 
-  // Operador de atribuicao por copia
+  // Operador de atribuicao por copia (tambem compartilha a estrutura de C: O(1))
   Circuito& operator=(const Circuito& C);
   // Operador de atribuicao por movimento
   Circuito& operator=(Circuito&& C) noexcept;
@@ -148,14 +252,33 @@ public:
   // IdPort eh uma id de porta valida e a porta estah alocada.
   bool definedPort(int IdPort) const
   {
-    return (validIdPort(IdPort) && ports.at(IdPort-1)!=nullptr);
+    return (validIdPort(IdPort) && estr->ports.at(IdPort-1)!=nullptr);
   }
 
   // Retorna true se o circuito eh valido (estah com todos os dados corretos):
   // - numero de entradas, saidas e portas valido
   // - todas as portas validas
   // - todas as saidas com Id de origem validas
-  bool valid() const;
+  // O teste soh eh refeito se o circuito foi alterado desde a ultima chamada.
+  bool valid() const
+  {
+    if (!validade_atualizada)
+    {
+      valido = testarValidade();
+      validade_atualizada = true;
+    }
+    return valido;
+  }
+
+  // Retorna true se o circuito tem algum laco combinacional
+  // (a saida de uma porta depende, direta ou indiretamente, dela mesma).
+  // Soh faz sentido para circuitos validos: retorna false se o circuito for invalido.
+  bool possuiCiclo();
+
+  // Retorna os lacos combinacionais do circuito: para cada laco (componente fortemente
+  // conexa com realimentacao), as ids, em ordem crescente, das portas que o formam.
+  // Retorna um vetor vazio se o circuito nao tiver lacos ou se for invalido.
+  std::vector< std::vector<int> > getLacos();
 
   /// ***********************
   /// Funcoes de consulta
@@ -172,7 +295,7 @@ public:
   }
   int getNumPorts() const
   {
-    return int(ports.size());
+    return int(estr->ports.size());
   }
 
   // Retorna o nome da porta cuja id eh IdPort: AN, NX, etc
@@ -180,7 +303,7 @@ public:
   std::string getNamePort(int IdPort) const
   {
     return (definedPort(IdPort) ?
-            ports.at(IdPort-1)->getName() :
+            estr->ports.at(IdPort-1)->getName() :
             "??");
   }
 
@@ -189,16 +312,17 @@ public:
   int getNumInputsPort(int IdPort) const
   {
     return (definedPort(IdPort) ?
-            ports.at(IdPort-1)->getNumInputs() :
+            estr->ports.at(IdPort-1)->getNumInputs() :
             0);
   }
 
   // Retorna o valor logico atual da saida da porta cuja id eh IdPort
-  // ou bool3S::UNDEF se o parametro for invalido.
+  // (calculado na ultima simulacao) ou bool3S::UNDEF se o parametro for invalido
+  // ou se o circuito foi alterado desde a ultima simulacao.
   bool3S getOutputPort(int IdPort) const
   {
-    return (definedPort(IdPort) ?
-            ports.at(IdPort-1)->getOutput() :
+    return (definedPort(IdPort) && comp!=nullptr ?
+            comp->getOutputPort(IdPort-1) :
             bool3S::UNDEF);
   }
 
@@ -211,12 +335,32 @@ public:
             bool3S::UNDEF);
   }
 
+  // Retorna os 64 valores logicos da saida do circuito cuja id eh IdOutput
+  // calculados na ultima simulacao bit-paralela (simular64),
+  // ou 64 valores bool3S::UNDEF se o parametro for invalido.
+  bool3S_64 getOutputCirc64(int IdOutput) const
+  {
+    return (validIdOutputCirc(IdOutput) && comp!=nullptr ?
+            comp->getOutputCirc64(IdOutput-1) :
+            toBool3S_64(bool3S::UNDEF));
+  }
+
+  // Retorna os BOOL3S_BLOCO valores logicos da saida do circuito cuja id eh IdOutput
+  // calculados na ultima simulacao vetorial (simularBloco),
+  // ou valores bool3S::UNDEF se o parametro for invalido.
+  bool3S_bloco getOutputCircBloco(int IdOutput) const
+  {
+    return (validIdOutputCirc(IdOutput) && comp!=nullptr ?
+            comp->getOutputCircBloco(IdOutput-1) :
+            toBool3S_bloco(bool3S::UNDEF));
+  }
+
   // Retorna a origem (a id) da I-esima entrada da porta cuja id eh IdPort
   // ou 0 se algum parametro for invalido.
   int getIdInPort(int IdPort, int I) const
   {
-    return ((definedPort(IdPort) && ports.at(IdPort-1)->validIndex(I)) ?
-            id_in.at(IdPort-1).at(I) :
+    return ((definedPort(IdPort) && estr->ports.at(IdPort-1)->validIndex(I)) ?
+            estr->id_in[IdPort-1][I] :
             0);
   }
 
@@ -225,10 +369,19 @@ public:
   int getIdOutputCirc(int IdOutput) const
   {
     return (validIdOutputCirc(IdOutput) ?
-            id_out.at(IdOutput-1) :
+            estr->id_out.at(IdOutput-1) :
             0);
   }
 
+  // Retorna a representacao compilada do circuito (vetores contiguos, somente leitura),
+  // montando-a se o circuito foi alterado desde a ultima vez.
+  // Soh deve ser chamada para circuitos validos.
+  const CircuitoCompilado& getCompilado()
+  {
+    compilar();
+    return *comp;
+  }
+
   /// ***********************
   /// Funcoes de modificacao
   /// ***********************
@@ -248,6 +401,16 @@ public:
   // Se der tudo certo, retorna true. Se algum parametro for invalido, retorna false.
   bool setIdOutputCirc(int IdOut, int IdOrig);
 
+  // Substitui todo o circuito por um circuito com NI entradas, tipo.size() portas e
+  // idOut.size() saidas, em formato CSR: a porta de indice i (id=i+1) eh do tipo tipo[i]
+  // e as ids das origens das suas entradas sao idIn[iniIn[i]] ... idIn[iniIn[i+1]-1];
+  // a saida de indice j (id=j+1) vem da origem de id idOut[j].
+  // As portas e as conexoes sao criadas diretamente na estrutura do novo circuito,
+  // sem uma chamada de setPort e de setIdInPort para cada uma (usada pelos importadores).
+  // Se algum dado for invalido, nao altera o circuito e retorna false.
+  bool montar(int NI, const std::vector<TipoPorta>& tipo, const std::vector<int>& iniIn,
+              const std::vector<int>& idIn, const std::vector<int>& idOut);
+
   /// ***********************
   /// E/S de dados
   /// ***********************
@@ -257,6 +420,16 @@ public:
   // Se deu tudo OK, altera o circuito e retorna true.
   bool ler(const std::string& arq);
 
+  // Entrada dos dados de um circuito via arquivo, como ler (mesmo formato), mas muito
+  // mais rapida para arquivos grandes: o arquivo eh mapeado na memoria e lido em uma
+  // unica passada, com leitura direta dos numeros e palavras (LeitorTexto), criando as
+  // portas e as conexoes diretamente na estrutura do novo circuito.
+  // Se ler um dado invalido, nao altera o circuito e retorna false; nesse caso, se
+  // erro!=nullptr, preenche *erro com a linha, a coluna e o motivo do primeiro erro.
+  // (Ao contrario de ler, tambem aceita um arquivo sem quebra de linha no final.)
+  // Se deu tudo OK, altera o circuito e retorna true.
+  bool lerRapido(const std::string& arq, ErroLeitura* erro=nullptr);
+
   // Saida dos dados de um circuito (em tela ou arquivo, a mesma funcao serve para os dois).
   // Soh deve escrever se o circuito for valido.
   // Retorna uma referencia aa mesma ostream que recebeu como parametro.
@@ -267,15 +440,107 @@ public:
   // Se deu tudo OK, retorna true; false se deu erro.
   bool salvar(const std::string& arq) const;
 
+  // Salvar circuito em arquivo binario, caso o circuito seja valido.
+  // O arquivo contem a representacao compilada (CircuitoCompilado::salvarBinario).
+  // Se deu tudo OK, retorna true; false se deu erro.
+  bool salvarBinario(const std::string& arq) const;
+
+  // Entrada dos dados de um circuito via arquivo binario (salvo com salvarBinario).
+  // A representacao compilada eh usada diretamente no arquivo mapeado na memoria
+  // (CircuitoCompilado::lerBinario): o circuito jah pode ser simulado, sem compilar.
+  // Um arquivo corrompido eh rejeitado pela soma de verificacao ou pela conferencia dos
+  // indices e da estrutura (fanout, ordem topologica, lacos e niveis) feita ao le-lo.
+  // As portas e as conexoes (usadas para consultar e alterar o circuito) sao montadas
+  // a partir dela em uma unica passada, sem nenhum teste adicional.
+  // Para apenas simular, CircuitoCompilado::lerBinario evita tambem essa montagem.
+  // Se o arquivo for invalido, o metodo nao altera o circuito e retorna false.
+  // Se deu tudo OK, altera o circuito e retorna true.
+  bool lerBinario(const std::string& arq);
+
   /// ***********************
   /// SIMULACAO (funcao principal do circuito)
   /// ***********************
 
+  // Todas as simulacoes usam como area de trabalho os vetores da representacao compilada
+  // (valores de todos os sinais e filas de eventos), que pertence ao circuito e eh alocada
+  // uma unica vez: enquanto o circuito nao for alterado, simular nao aloca memoria.
+  // Para simular com uma area de trabalho fornecida pelo chamador (por exemplo, uma por
+  // thread), use getCompilado().simular(in, V).
+
   // Calcula as saidas do circuito para os valores de entrada passados como parametro,
   // caso o circuito e o parametro de entrada sejam validos.
+  // Circuitos sem lacos sao avaliados em uma unica passada, na ordem topologica;
+  // circuitos com lacos sao avaliados iterativamente ateh estabilizar.
   // Retorna true se a simulacao foi OK; false em caso de erro.
   bool simular(const std::vector<bool3S>& in_circ);
 
+  // Calcula as saidas do circuito como simular, mas reavaliando apenas as portas
+  // afetadas pelas entradas que mudaram desde a ultima simulacao (simulacao dirigida
+  // por eventos). Eh a melhor opcao quando vetores consecutivos diferem em poucas entradas.
+  // Retorna true se a simulacao foi OK; false em caso de erro.
+  bool simularEventos(const std::vector<bool3S>& in_circ);
+
+  // Simulacao bit-paralela: calcula as saidas do circuito para 64 vetores de entrada
+  // simultaneos. A k-esima posicao de in_circ.at(j) eh o valor da entrada id=-(j+1)
+  // no k-esimo vetor. As saidas sao consultadas com getOutputCirc64.
+  // Retorna true se a simulacao foi OK; false em caso de erro.
+  bool simular64(const std::vector<bool3S_64>& in_circ);
+
+  // Simulacao vetorial (SIMD): calcula as saidas do circuito para BOOL3S_BLOCO vetores
+  // de entrada simultaneos, com o kernel K ou, se K==nullptr, com o melhor kernel
+  // suportado pela CPU (AVX-512, AVX2 ou escalar).
+  // As saidas sao consultadas com getOutputCircBloco.
+  // Retorna true se a simulacao foi OK; false em caso de erro.
+  bool simularBloco(const std::vector<bool3S_bloco>& in_circ, KernelPorta K=nullptr);
+
+  // Calcula apenas as saidas do circuito cujas ids estao em IdOutputs, simulando somente
+  // as portas do cone de influencia dessas saidas (as portas das quais elas dependem).
+  // Os cones sao calculados na primeira vez e guardados ateh que o circuito seja alterado.
+  // As demais saidas do circuito ficam indefinidas (bool3S::UNDEF).
+  // Retorna true se a simulacao foi OK; false em caso de erro.
+  bool simularSaidas(const std::vector<int>& IdOutputs, const std::vector<bool3S>& in_circ);
+
+  // Retorna as ids (-1, -2, etc., em ordem) das entradas do circuito das quais dependem
+  // as saidas cujas ids estao em IdOutputs, ou um vetor vazio em caso de erro.
+  std::vector<int> getEntradasCone(const std::vector<int>& IdOutputs);
+
+
+  /// ***********************
+  /// TABELA VERDADE
+  /// ***********************
+
+  // Gera, uma a uma, todas as linhas da tabela verdade do circuito, na ordem pedida,
+  // entregando cada linha ao receptor. Usa memoria constante (nenhuma linha eh guardada).
+  // Em todas as funcoes de geracao da tabela verdade (exceto a binaria), o numero de
+  // entradas enumeradas deve ser no maximo MAX_ENTRADAS_TABELA (39), para que os numeros
+  // das linhas caibam em um long long.
+  // Retorna false se o circuito for invalido, se tiver entradas demais ou se a geracao
+  // foi interrompida pelo receptor.
+  bool gerarTabela(const ReceptorLinha& receptor, OrdemTabela ordem=OrdemTabela::CANONICA);
+
+  // Gera as linhas da tabela verdade em paralelo, com as threads do pool P.
+  // O receptor eh chamado pela thread que chamou esta funcao, na ordem canonica.
+  // Retorna false se o circuito for invalido, se tiver entradas demais ou se a geracao
+  // foi interrompida pelo receptor.
+  bool gerarTabela(const ReceptorLinha& receptor, PoolTrabalho& P);
+
+  // Gera as 2^NI linhas da tabela verdade binaria: apenas as combinacoes de entradas sem
+  // UNDEF (FALSE e TRUE), na ordem canonica da base 2 (numLinhasTabelaBinaria).
+  // Simula 64 linhas de uma vez; circuitos sem lacos usam a simulacao binaria (um bit por
+  // linha), mais rapida. Circuitos com lacos usam a simulacao ternaria, pois as saidas
+  // podem ser UNDEF mesmo com todas as entradas definidas.
+  // Retorna false se o circuito for invalido, se tiver mais de MAX_ENTRADAS_BINARIA (62)
+  // entradas ou se a geracao foi interrompida pelo receptor.
+  bool gerarTabelaBinaria(const ReceptorLinha& receptor);
+
+  // Gera a tabela verdade apenas das saidas cujas ids estao em IdOutputs, enumerando somente
+  // as k entradas das quais elas dependem (getEntradasCone): 3^k linhas em vez de 3^NI.
+  // O receptor recebe o numero da linha (na ordem canonica das k entradas), os valores
+  // dessas k entradas e os valores das saidas pedidas, na ordem de IdOutputs.
+  // O limite de MAX_ENTRADAS_TABELA vale para as k entradas do cone, e nao para NI.
+  // Retorna false se o circuito ou alguma id forem invalidos, se o cone tiver entradas
+  // demais ou se a geracao foi interrompida pelo receptor.
+  bool gerarTabela(const std::vector<int>& IdOutputs, const ReceptorLinha& receptor);
 };
 
 // Operador de impressao da classe Circuit
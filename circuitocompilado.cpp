@@ -0,0 +1,929 @@
+#include <algorithm>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <cstddef>
+#include "circuitocompilado.h"
+#include "arquivomapeado.h"
+
+///
+/// CLASSE CIRCUITO COMPILADO
+///
+
+/// ***********************
+/// Inicializacao e finalizacao
+/// ***********************
+
+// Construtor default
+CircuitoCompilado::CircuitoCompilado():
+  Nin_circ(0),
+  tipo(),
+  ini_in(),
+  sinal_in(),
+  sinal_out(),
+  ini_fanout(),
+  fanout(),
+  ordem(),
+  ini_laco(),
+  fim_laco(),
+  com_ciclo(false),
+  nivel(),
+  Nniveis(0),
+  valor(),
+  estado_valido(false),
+  agendada(),
+  eventos(),
+  valor64(),
+  valorBloco(),
+  valorBinario(),
+  cones()
+{}
+
+// Limpa todo o conteudo
+void CircuitoCompilado::clear() noexcept
+{
+  Nin_circ = 0;
+  tipo.clear();
+  ini_in.clear();
+  sinal_in.clear();
+  sinal_out.clear();
+  ini_fanout.clear();
+  fanout.clear();
+  ordem.clear();
+  ini_laco.clear();
+  fim_laco.clear();
+  com_ciclo = false;
+  nivel.clear();
+  Nniveis = 0;
+  valor.clear();
+  estado_valido = false;
+  agendada.clear();
+  eventos.clear();
+  valor64.clear();
+  valorBloco.clear();
+  valorBinario.clear();
+  cones.clear();
+}
+
+// Monta a representacao compilada
+void CircuitoCompilado::compilar(int NI, const std::vector<ptr_Porta>& ports,
+                                 const ConexoesPortas& id_in, const std::vector<int>& id_out)
+{
+  int NP = int(ports.size());
+  int i;
+
+  clear();
+  Nin_circ = NI;
+
+  // Tipos e conectividade das portas
+  std::vector<TipoPorta> tp(NP);
+  std::vector<int> ini(NP+1);
+  ini[0] = 0;
+  for (i=0; i<NP; ++i)
+  {
+    tp[i] = ports[i]->getTipo();
+    ini[i+1] = ini[i] + ports[i]->getNumInputs();
+  }
+  std::vector<int> orig(ini[NP]);
+  for (i=0; i<NP; ++i)
+  {
+    for (int j=0; j<ports[i]->getNumInputs(); ++j)
+    {
+      orig[ini[i]+j] = sinal(id_in[i][j]);
+    }
+  }
+  tipo = std::move(tp);
+  ini_in = std::move(ini);
+  sinal_in = std::move(orig);
+
+  // Origens das saidas
+  std::vector<int> saidas(id_out.size());
+  for (i=0; i<int(id_out.size()); ++i) saidas[i] = sinal(id_out[i]);
+  sinal_out = std::move(saidas);
+
+  // Valores dos sinais
+  valor.assign(NI+NP, bool3S::UNDEF);
+
+  levelizar();
+}
+
+// Calcula as listas de fanout, os lacos, a ordem topologica e os niveis das portas
+// (montados em vetores locais, que depois passam a ser os vetores compilados)
+void CircuitoCompilado::levelizar()
+{
+  int NP = getNumPorts();
+  int NS = Nin_circ+NP;
+  int i, k;
+
+  // Listas (CSR) das portas que recebem cada sinal (entrada do circuito ou saida de porta)
+  std::vector<int> ini_fo(NS+1, 0);
+  for (k=0; k<getNumConexoes(); ++k) ++ini_fo[sinal_in[k]+1];
+  for (i=0; i<NS; ++i) ini_fo[i+1] += ini_fo[i];
+  std::vector<int> fo(ini_fo[NS]);
+  std::vector<int> pos(ini_fo.begin(), ini_fo.end()-1);
+  for (i=0; i<NP; ++i)
+  {
+    for (k=ini_in[i]; k<ini_in[i+1]; ++k) fo[pos[sinal_in[k]]++] = i;
+  }
+
+  // Componentes fortemente conexas do grafo das portas (algoritmo de Tarjan, na versao
+  // iterativa, com uma pilha explicita de chamadas, para nao estourar a pilha do programa
+  // em circuitos profundos). Cada componente eh emitida depois de todas as componentes
+  // que ela influencia: ao final, comp contem as componentes na ordem topologica inversa.
+  std::vector<int> indice(NP, -1), menor(NP, 0), pilha, comp;
+  std::vector<int> ini_comp(1, 0);
+  std::vector<char> naPilha(NP, 0);
+  std::vector< std::pair<int,int> > chamadas; // (porta, proxima posicao no fanout)
+  int contador = 0;
+
+  for (int raiz=0; raiz<NP; ++raiz)
+  {
+    if (indice[raiz] >= 0) continue;
+    indice[raiz] = menor[raiz] = contador++;
+    pilha.push_back(raiz);
+    naPilha[raiz] = 1;
+    chamadas.push_back(std::make_pair(raiz, ini_fo[Nin_circ+raiz]));
+
+    while (!chamadas.empty())
+    {
+      int v = chamadas.back().first;
+      k = chamadas.back().second;
+      if (k < ini_fo[Nin_circ+v+1])
+      {
+        // Proxima porta w que recebe o sinal de v
+        int w = fo[k];
+        ++chamadas.back().second;
+        if (indice[w] < 0)
+        {
+          indice[w] = menor[w] = contador++;
+          pilha.push_back(w);
+          naPilha[w] = 1;
+          chamadas.push_back(std::make_pair(w, ini_fo[Nin_circ+w]));
+        }
+        else if (naPilha[w]) menor[v] = std::min(menor[v], indice[w]);
+      }
+      else
+      {
+        // v terminou: se for a raiz de uma componente, desempilha a componente
+        if (menor[v] == indice[v])
+        {
+          int w;
+          do
+          {
+            w = pilha.back();
+            pilha.pop_back();
+            naPilha[w] = 0;
+            comp.push_back(w);
+          } while (w != v);
+          ini_comp.push_back(int(comp.size()));
+        }
+        chamadas.pop_back();
+        if (!chamadas.empty())
+        {
+          int u = chamadas.back().first;
+          menor[u] = std::min(menor[u], menor[v]);
+        }
+      }
+    }
+  }
+
+  // Ordem topologica: as componentes em ordem inversa aa de Tarjan.
+  // As componentes com realimentacao sao os lacos.
+  std::vector<int> ord, ini_l, fim_l;
+  ord.reserve(NP);
+  std::vector<int> componente(NP);
+  for (int c=int(ini_comp.size())-2; c>=0; --c)
+  {
+    int ini = int(ord.size());
+    for (k=ini_comp[c]; k<ini_comp[c+1]; ++k) ord.push_back(comp[k]);
+    std::sort(ord.begin()+ini, ord.end());
+    for (k=ini; k<int(ord.size()); ++k) componente[ord[k]] = ini;
+
+    bool realimentada = (int(ord.size())-ini > 1);
+    if (!realimentada)
+    {
+      // Uma porta sozinha soh forma um laco se receber a sua propria saida
+      int p = ord[ini];
+      for (k=ini_in[p]; k<ini_in[p+1]; ++k)
+      {
+        if (sinal_in[k] == Nin_circ+p) realimentada = true;
+      }
+    }
+    if (realimentada)
+    {
+      ini_l.push_back(ini);
+      fim_l.push_back(int(ord.size()));
+    }
+  }
+  com_ciclo = !ini_l.empty();
+
+  // Nivel de cada porta: 1 + maior nivel entre as portas das quais recebe sinais
+  // (as entradas do circuito estao no nivel 0). As portas de um laco recebem todas
+  // o nivel calculado a partir das portas de fora do laco.
+  std::vector<int> niv(NP, 0);
+  Nniveis = 1;
+  for (int j=0; j<NP; )
+  {
+    int c = componente[ord[j]];
+    int fim = j;
+    int n = 0;
+    while (fim<NP && componente[ord[fim]]==c)
+    {
+      int p = ord[fim++];
+      for (k=ini_in[p]; k<ini_in[p+1]; ++k)
+      {
+        int s = sinal_in[k]-Nin_circ;
+        if (s >= 0 && componente[s] != c) n = std::max(n, niv[s]);
+      }
+    }
+    for (; j<fim; ++j) niv[ord[j]] = n+1;
+    Nniveis = std::max(Nniveis, n+2);
+  }
+
+  ini_fanout = std::move(ini_fo);
+  fanout = std::move(fo);
+  ordem = std::move(ord);
+  ini_laco = std::move(ini_l);
+  fim_laco = std::move(fim_l);
+  nivel = std::move(niv);
+}
+
+// Confere o fanout, a ordem topologica, os lacos e os niveis a partir das conexoes
+bool CircuitoCompilado::estruturaCoerente() const
+{
+  const int NP = getNumPorts();
+  const int NS = Nin_circ+NP;
+  int i, j, k;
+
+  // Fanout: exatamente as listas que levelizar monta a partir de sinal_in.
+  // Como ini_fanout[NS] eh o numero de conexoes, todas as posicoes sao preenchidas.
+  std::vector<int> pos(ini_fanout.data(), ini_fanout.data()+NS);
+  for (i=0; i<NP; ++i)
+  {
+    for (k=ini_in[i]; k<ini_in[i+1]; ++k)
+    {
+      int s = sinal_in[k];
+      if (pos[s]>=ini_fanout[s+1] || fanout[pos[s]++]!=i) return false;
+    }
+  }
+
+  // Ordem: uma permutacao das portas; posicao[p] eh a posicao da porta p na ordem
+  std::vector<int> posicao(NP, -1);
+  for (j=0; j<NP; ++j)
+  {
+    if (posicao[ordem[j]]>=0) return false;
+    posicao[ordem[j]] = j;
+  }
+
+  // Conta as portas do trecho [ini, fim) da ordem alcancadas a partir da porta ordem[ini]
+  // por um ou mais arcos dentro do trecho: em frente (fanout) ou para tras (sinal_in).
+  // O trecho eh fortemente conexo (um laco) se as duas contagens forem iguais a fim-ini.
+  std::vector<int> marca(NP, -1), pilha;
+  auto alcancadas = [&](int ini, int fim, bool emFrente, int m)
+  {
+    int N = 0;
+    pilha.assign(1, ordem[ini]);
+    while (!pilha.empty())
+    {
+      int p = pilha.back();
+      pilha.pop_back();
+      int kIni = (emFrente ? ini_fanout[Nin_circ+p] : ini_in[p]);
+      int kFim = (emFrente ? ini_fanout[Nin_circ+p+1] : ini_in[p+1]);
+      for (k=kIni; k<kFim; ++k)
+      {
+        int w = (emFrente ? fanout[k] : sinal_in[k]-Nin_circ);
+        if (w>=0 && posicao[w]>=ini && posicao[w]<fim && marca[w]!=m)
+        {
+          marca[w] = m;
+          ++N;
+          pilha.push_back(w);
+        }
+      }
+    }
+    return N;
+  };
+
+  // Percorre a ordem por trechos: um laco ou uma porta isolada. Os lacos devem ser
+  // disjuntos, crescentes e fortemente conexos; cada porta soh recebe sinais de portas
+  // anteriores na ordem ou do seu proprio trecho (uma porta isolada nunca recebe a propria
+  // saida). O nivel de todas as portas do trecho eh 1 + o maior nivel entre as portas de
+  // fora do trecho das quais ele recebe sinais.
+  int c = 0, maiorNivel = 0;
+  for (j=0; j<NP; )
+  {
+    const int ini = j;
+    int fim = j+1;
+    const bool laco = (c<getNumLacos() && ini_laco[c]==ini);
+    if (laco)
+    {
+      fim = fim_laco[c];
+      if (alcancadas(ini, fim, true, 2*c)!=fim-ini ||
+          alcancadas(ini, fim, false, 2*c+1)!=fim-ini) return false;
+      ++c;
+    }
+    if (c<getNumLacos() && ini_laco[c]<fim) return false;
+
+    int n = 0;
+    for (; j<fim; ++j)
+    {
+      int p = ordem[j];
+      for (k=ini_in[p]; k<ini_in[p+1]; ++k)
+      {
+        int q = sinal_in[k]-Nin_circ;
+        if (q<0) continue;
+        if (posicao[q]>=fim || (posicao[q]>=ini && !laco)) return false;
+        if (posicao[q]<ini) n = std::max(n, nivel[q]);
+      }
+    }
+    for (j=ini; j<fim; ++j)
+    {
+      if (nivel[ordem[j]]!=n+1) return false;
+    }
+    maiorNivel = std::max(maiorNivel, n+1);
+  }
+  return c==getNumLacos() && Nniveis==maiorNivel+1;
+}
+
+// Indices das portas que formam o laco c
+std::vector<int> CircuitoCompilado::getPortasLaco(int c) const
+{
+  return std::vector<int>(ordem.begin()+ini_laco[c], ordem.begin()+fim_laco[c]);
+}
+
+/// ***********************
+/// SIMULACAO
+/// ***********************
+
+// Avalia todas as portas, iterando os lacos ateh o ponto fixo nos dominios ternarios
+template <class T, class Avaliador>
+void CircuitoCompilado::simularCircuito(T* V, Avaliador avaliar) const
+{
+  // Circuitos sem lacos nao precisam da iteracao ateh o ponto fixo.
+  // Nos dominios binarios nao ha UNDEF para iniciar os lacos: o circuito nao pode te-los.
+  if (com_ciclo && DominioValor<T>::ternario)
+  {
+    simularOrdem(ordem.data(), getNumPorts(), ini_laco.data(), fim_laco.data(), getNumLacos(),
+                 V, avaliar);
+  }
+  else
+  {
+    for (int i : ordem) avaliar(i, V, V[Nin_circ+i]);
+  }
+}
+
+// Avalia as portas ord, na ordem, iterando os lacos [ini_l[c], fim_l[c]) ateh o ponto fixo
+template <class T, class Avaliador>
+void CircuitoCompilado::simularOrdem(const int* ord, int N, const int* ini_l, const int* fim_l,
+                                     int Nlacos, T* V, Avaliador avaliar) const
+{
+  int j = 0;
+
+  for (int c=0; c<=Nlacos; ++c)
+  {
+    // Portas (fora de lacos) anteriores ao laco c
+    int fim = (c<Nlacos ? ini_l[c] : N);
+    for (; j<fim; ++j) avaliar(ord[j], V, V[Nin_circ+ord[j]]);
+    // O laco c: todas as portas das quais ele depende jah foram avaliadas
+    if (c<Nlacos)
+    {
+      simularLaco(ord+ini_l[c], fim_l[c]-ini_l[c], V, avaliar);
+      j = fim_l[c];
+    }
+  }
+}
+
+// Reavalia as portas nao definidas de um laco ateh que nenhuma mude.
+// Como as portas partem de UNDEF e sao monotonas, o resultado nao depende da ordem
+// de avaliacao: eh o mesmo ponto fixo da iteracao sobre o circuito inteiro, em cada
+// posicao dos dominios bit-paralelos. Pela mesma razao, uma porta definida em todas
+// as posicoes nao muda mais e nao precisa ser reavaliada.
+template <class T, class Avaliador>
+void CircuitoCompilado::simularLaco(const int* portas, int N, T* V, Avaliador avaliar) const
+{
+  using D = DominioValor<T>;
+  bool todasDefinidas, algumaAtualizada;
+  T* saidaPorta = V+Nin_circ;
+  T novo;
+  int j;
+
+  // Inicializa as saidas das portas do laco como indefinidas
+  for (j=0; j<N; ++j) saidaPorta[portas[j]] = D::indefinido();
+
+  do
+  {
+    todasDefinidas = true;
+    algumaAtualizada = false;
+    for (j=0; j<N; ++j)
+    {
+      int i = portas[j];
+      if (!D::definido(saidaPorta[i]))
+      {
+        avaliar(i, V, novo);
+        if (novo != saidaPorta[i])
+        {
+          saidaPorta[i] = novo;
+          algumaAtualizada = true;
+        }
+        if (!D::definido(novo)) todasDefinidas = false;
+      }
+    }
+  } while (!todasDefinidas && algumaAtualizada);
+}
+
+// Calcula os valores de todos os sinais para as entradas in_circ
+void CircuitoCompilado::simular(const bool3S* in_circ)
+{
+  simular(in_circ, valor.data());
+  estado_valido = true;
+}
+
+// Calcula os valores de todos os sinais no dominio T, armazenando-os em V
+template <class T>
+void CircuitoCompilado::simular(const T* in_circ, T* V) const
+{
+  for (int i=0; i<Nin_circ; ++i) V[i] = in_circ[i];
+  simularCircuito(V, AvaliadorGenerico<T>{this});
+}
+
+// As instancias da simulacao generica para cada dominio de valores
+template void CircuitoCompilado::simular(const bool3S*, bool3S*) const;
+template void CircuitoCompilado::simular(const bool3S_64*, bool3S_64*) const;
+template void CircuitoCompilado::simular(const bool3S_bloco*, bool3S_bloco*) const;
+template void CircuitoCompilado::simular(const bool*, bool*) const;
+template void CircuitoCompilado::simular(const uint64_t*, uint64_t*) const;
+
+/// ***********************
+/// CONES DE INFLUENCIA
+/// ***********************
+
+// Retorna o cone de influencia de um conjunto de saidas (calculado na primeira vez)
+std::shared_ptr<const ConeInfluencia> CircuitoCompilado::getCone(std::vector<int> saidas)
+{
+  std::sort(saidas.begin(), saidas.end());
+  saidas.erase(std::unique(saidas.begin(), saidas.end()), saidas.end());
+
+  auto achou = cones.find(saidas);
+  if (achou != cones.end()) return achou->second;
+
+  int NP = getNumPorts();
+  int j, k;
+  auto K = std::make_shared<ConeInfluencia>();
+  K->saidas = saidas;
+
+  // Marca os sinais dos quais as saidas dependem, percorrendo as conexoes de tras para frente
+  std::vector<char> marcado(getNumSinais(), 0);
+  std::vector<int> pendentes;
+  for (int o : saidas)
+  {
+    if (!marcado[sinal_out[o]])
+    {
+      marcado[sinal_out[o]] = 1;
+      pendentes.push_back(sinal_out[o]);
+    }
+  }
+  while (!pendentes.empty())
+  {
+    int s = pendentes.back();
+    pendentes.pop_back();
+    if (s < Nin_circ) continue;
+    int p = s-Nin_circ;
+    for (k=ini_in[p]; k<ini_in[p+1]; ++k)
+    {
+      if (!marcado[sinal_in[k]])
+      {
+        marcado[sinal_in[k]] = 1;
+        pendentes.push_back(sinal_in[k]);
+      }
+    }
+  }
+
+  // Entradas do circuito do cone
+  for (int i=0; i<Nin_circ; ++i)
+  {
+    if (marcado[i]) K->entradas.push_back(i);
+  }
+
+  // Portas do cone, na ordem topologica do circuito.
+  // Um laco esta inteiro no cone ou inteiro fora dele (todas as suas portas
+  // dependem umas das outras), entao continua sendo um trecho contiguo da ordem.
+  int c = 0;
+  for (j=0; j<NP; ++j)
+  {
+    bool inicioLaco = (c<getNumLacos() && j==ini_laco[c]);
+    if (inicioLaco && marcado[Nin_circ+ordem[j]]) K->ini_laco.push_back(int(K->ordem.size()));
+    if (marcado[Nin_circ+ordem[j]]) K->ordem.push_back(ordem[j]);
+    if (c<getNumLacos() && j==fim_laco[c]-1)
+    {
+      if (marcado[Nin_circ+ordem[j]]) K->fim_laco.push_back(int(K->ordem.size()));
+      ++c;
+    }
+  }
+
+  cones[saidas] = K;
+  return K;
+}
+
+// Calcula os valores dos sinais do cone K, armazenando-os em V
+void CircuitoCompilado::simularCone(const ConeInfluencia& K, const bool3S* in_circ, bool3S* V) const
+{
+  for (int i : K.entradas) V[i] = in_circ[i];
+  simularOrdem(K.ordem.data(), int(K.ordem.size()), K.ini_laco.data(), K.fim_laco.data(),
+               int(K.ini_laco.size()), V, AvaliadorGenerico<bool3S>{this});
+}
+
+// Calcula os valores dos sinais do cone K
+void CircuitoCompilado::simularCone(const ConeInfluencia& K, const bool3S* in_circ)
+{
+  simularCone(K, in_circ, valor.data());
+  // Os sinais fora do cone nao correspondem mais aas entradas atuais
+  estado_valido = false;
+}
+
+/// ***********************
+/// SIMULACAO DIRIGIDA POR EVENTOS
+/// ***********************
+
+// Agenda para reavaliacao todas as portas que recebem o sinal s
+void CircuitoCompilado::agendarFanout(int s)
+{
+  for (int k=ini_fanout[s]; k<ini_fanout[s+1]; ++k)
+  {
+    int p = fanout[k];
+    if (!agendada[p])
+    {
+      agendada[p] = 1;
+      eventos[nivel[p]].push_back(p);
+    }
+  }
+}
+
+// Atualiza os valores dos sinais reavaliando somente as portas afetadas
+// pelas entradas que mudaram desde a ultima simulacao
+void CircuitoCompilado::simularEventos(const bool3S* in_circ)
+{
+  // Sem um estado anterior consistente (ou com lacos), faz a simulacao completa
+  if (!estado_valido || com_ciclo)
+  {
+    simular(in_circ);
+    return;
+  }
+  if (int(eventos.size()) != Nniveis)
+  {
+    // Cada porta eh agendada no maximo uma vez: a fila de cada nivel nunca tem mais
+    // portas do que o nivel. Reservando esse tamanho, as filas nunca sao realocadas.
+    std::vector<int> Nportas(Nniveis, 0);
+    for (int p=0; p<getNumPorts(); ++p) ++Nportas[nivel[p]];
+    eventos.resize(Nniveis);
+    for (int n=0; n<Nniveis; ++n) eventos[n].reserve(Nportas[n]);
+    agendada.assign(getNumPorts(), 0);
+  }
+
+  // Agenda o fanout das entradas que mudaram
+  for (int i=0; i<Nin_circ; ++i)
+  {
+    if (valor[i] != in_circ[i])
+    {
+      valor[i] = in_circ[i];
+      agendarFanout(i);
+    }
+  }
+
+  // Avalia as portas agendadas nivel a nivel. Como uma porta soh recebe sinais de
+  // niveis menores, quando um nivel eh processado todas as suas entradas jah estao
+  // atualizadas e cada porta eh avaliada no maximo uma vez.
+  for (int n=1; n<Nniveis; ++n)
+  {
+    std::vector<int>& fila = eventos[n];
+    for (size_t j=0; j<fila.size(); ++j)
+    {
+      int p = fila[j];
+      agendada[p] = 0;
+      bool3S novo = avaliarPorta(p, valor.data());
+      // A propagacao para quando a saida da porta nao muda
+      if (novo != valor[Nin_circ+p])
+      {
+        valor[Nin_circ+p] = novo;
+        agendarFanout(Nin_circ+p);
+      }
+    }
+    fila.clear();
+  }
+}
+
+/// ***********************
+/// SIMULACAO BIT-PARALELA
+/// ***********************
+
+// Calcula os valores de todos os sinais para 64 vetores de entrada simultaneos.
+// Cada posicao converge para o mesmo valor que a simulacao escalar.
+void CircuitoCompilado::simular64(const bool3S_64* in_circ)
+{
+  if (valor64.size() != valor.size()) valor64.resize(valor.size());
+  simular(in_circ, valor64.data());
+}
+
+/// ***********************
+/// SIMULACAO BINARIA
+/// ***********************
+
+// Calcula os valores de todos os sinais para 64 vetores de entrada binarios
+void CircuitoCompilado::simularBinario(const uint64_t* in_circ)
+{
+  if (valorBinario.size() != valor.size()) valorBinario.resize(valor.size());
+  simular(in_circ, valorBinario.data());
+}
+
+/// ***********************
+/// SIMULACAO VETORIAL (SIMD)
+/// ***********************
+
+// Calcula os valores de todos os sinais para BOOL3S_BLOCO vetores de entrada simultaneos.
+// O nucleo de simulacao eh o mesmo dos demais dominios; apenas a avaliacao das portas
+// eh feita pelo kernel K, especifico do conjunto de instrucoes.
+void CircuitoCompilado::simularBloco(const bool3S_bloco* in_circ, KernelPorta K)
+{
+  if (K==nullptr) K = kernelPorta();
+  if (valorBloco.size() != valor.size()) valorBloco.resize(valor.size());
+  for (int i=0; i<Nin_circ; ++i) valorBloco[i] = in_circ[i];
+
+  const int* orig = sinal_in.data();
+  const int* ini = ini_in.data();
+  const TipoPorta* tp = tipo.data();
+  simularCircuito(valorBloco.data(), [K, orig, ini, tp](int i, const bool3S_bloco* V, bool3S_bloco& dest)
+  {
+    K(tp[i], orig+ini[i], ini[i+1]-ini[i], V, dest);
+  });
+}
+
+/// ***********************
+/// ARQUIVO BINARIO
+/// ***********************
+
+// Alinhamento (em bytes) do cabecalho e das secoes do arquivo binario
+static const size_t ALINHAMENTO_BINARIO = 64;
+// Identificacao e versao do formato binario
+static const char MAGICA_BINARIO[8] = {'C','I','R','C','B','I','N','\x1A'};
+static const uint32_t VERSAO_BINARIO = 1;
+// Gravado no arquivo com a ordem de bytes de quem o escreveu: soh eh lido
+// corretamente por uma maquina com a mesma ordem de bytes
+static const uint32_t ORDEM_BYTES_BINARIO = 0x01020304;
+
+// As secoes do arquivo binario, na ordem em que sao gravadas
+enum SecaoBinario
+{
+  SEC_TIPO, SEC_INI_IN, SEC_SINAL_IN, SEC_SINAL_OUT, SEC_INI_FANOUT, SEC_FANOUT,
+  SEC_ORDEM, SEC_INI_LACO, SEC_FIM_LACO, SEC_NIVEL, NUM_SECOES
+};
+
+// O cabecalho do arquivo binario
+struct CabecalhoBinario
+{
+  char magica[8];
+  uint32_t versao;
+  uint32_t ordemBytes;
+  // Dimensoes do circuito
+  int32_t NI, NO, NP, Nconexoes, Nlacos, Nniveis;
+  int32_t com_ciclo;
+  int32_t reservado;
+  // Tamanho total do arquivo (multiplo de ALINHAMENTO_BINARIO)
+  uint64_t tamanho;
+  // Soma de verificacao do arquivo inteiro (calculada com este campo igual a 0)
+  uint64_t verificacao;
+  // Posicao (a partir do inicio do arquivo) de cada secao
+  uint64_t secao[NUM_SECOES];
+};
+
+// Tamanho ocupado pelo cabecalho no arquivo (as secoes comecam em seguida)
+static const size_t TAM_CABECALHO =
+    (sizeof(CabecalhoBinario)+ALINHAMENTO_BINARIO-1)/ALINHAMENTO_BINARIO*ALINHAMENTO_BINARIO;
+
+// Arredonda N para o multiplo seguinte de ALINHAMENTO_BINARIO
+static uint64_t alinharBinario(uint64_t N)
+{
+  return (N+ALINHAMENTO_BINARIO-1)/ALINHAMENTO_BINARIO*ALINHAMENTO_BINARIO;
+}
+
+///
+/// SOMA DE VERIFICACAO
+///
+/// Le os dados em palavras de 64 bits, em quatro sequencias independentes (que o
+/// processador calcula em paralelo), combinadas no final. Os dados sao processados
+/// em blocos de ALINHAMENTO_BINARIO bytes: uma soma pode ser calculada por partes.
+///
+
+struct SomaVerificacao
+{
+  uint64_t h[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL,
+                   0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+
+  // Acrescenta N bytes (N multiplo de ALINHAMENTO_BINARIO)
+  void acrescentar(const char* dados, size_t N)
+  {
+    const uint64_t M = 0x9E3779B97F4A7C15ULL;
+    uint64_t w[4];
+    for (size_t k=0; k<N; k+=sizeof(w))
+    {
+      std::memcpy(w, dados+k, sizeof(w));
+      for (int j=0; j<4; ++j) h[j] = ((h[j]^w[j])*M) ^ (h[j]>>29);
+    }
+  }
+
+  // O valor da soma
+  uint64_t valor() const
+  {
+    uint64_t v = 0;
+    for (int j=0; j<4; ++j) v = (v ^ h[j]) * 0xBF58476D1CE4E5B9ULL + uint64_t(j);
+    return v ^ (v>>31);
+  }
+};
+
+// Salva a representacao compilada em um arquivo binario
+bool CircuitoCompilado::salvarBinario(const std::string& arq) const
+{
+  // Os vetores de cada secao (dados e tamanho em bytes)
+  const void* dados[NUM_SECOES] =
+  {
+    tipo.data(), ini_in.data(), sinal_in.data(), sinal_out.data(), ini_fanout.data(),
+    fanout.data(), ordem.data(), ini_laco.data(), fim_laco.data(), nivel.data()
+  };
+  const size_t bytes[NUM_SECOES] =
+  {
+    tipo.size()*sizeof(TipoPorta), ini_in.size()*sizeof(int), sinal_in.size()*sizeof(int),
+    sinal_out.size()*sizeof(int), ini_fanout.size()*sizeof(int), fanout.size()*sizeof(int),
+    ordem.size()*sizeof(int), ini_laco.size()*sizeof(int), fim_laco.size()*sizeof(int),
+    nivel.size()*sizeof(int)
+  };
+
+  CabecalhoBinario cab;
+  std::memset(&cab, 0, sizeof(cab));
+  std::memcpy(cab.magica, MAGICA_BINARIO, sizeof(cab.magica));
+  cab.versao = VERSAO_BINARIO;
+  cab.ordemBytes = ORDEM_BYTES_BINARIO;
+  cab.NI = Nin_circ;
+  cab.NO = getNumOutputs();
+  cab.NP = getNumPorts();
+  cab.Nconexoes = getNumConexoes();
+  cab.Nlacos = getNumLacos();
+  cab.Nniveis = Nniveis;
+  cab.com_ciclo = com_ciclo;
+  uint64_t pos = TAM_CABECALHO;
+  for (int k=0; k<NUM_SECOES; ++k)
+  {
+    cab.secao[k] = pos;
+    pos += alinharBinario(bytes[k]);
+  }
+  cab.tamanho = pos;
+
+  std::ofstream myfile(arq, std::ios::binary);
+  if (!myfile.is_open()) return false;
+
+  // O cabecalho eh gravado de novo no final, com a soma de verificacao
+  std::vector<char> buffer(TAM_CABECALHO, 0);
+  std::memcpy(buffer.data(), &cab, sizeof(cab));
+  myfile.write(buffer.data(), TAM_CABECALHO);
+  SomaVerificacao soma;
+  soma.acrescentar(buffer.data(), TAM_CABECALHO);
+
+  // Cada secao eh gravada seguida pelos zeros que completam o alinhamento.
+  // A parte final de cada secao (que nao completa um bloco) passa pelo buffer.
+  for (int k=0; k<NUM_SECOES; ++k)
+  {
+    size_t inteiros = bytes[k]/ALINHAMENTO_BINARIO*ALINHAMENTO_BINARIO;
+    const char* D = static_cast<const char*>(dados[k]);
+    if (inteiros>0)
+    {
+      myfile.write(D, inteiros);
+      soma.acrescentar(D, inteiros);
+    }
+    size_t resto = bytes[k]-inteiros;
+    if (resto>0)
+    {
+      buffer.assign(ALINHAMENTO_BINARIO, 0);
+      std::memcpy(buffer.data(), D+inteiros, resto);
+      myfile.write(buffer.data(), ALINHAMENTO_BINARIO);
+      soma.acrescentar(buffer.data(), ALINHAMENTO_BINARIO);
+    }
+  }
+  cab.verificacao = soma.valor();
+
+  buffer.assign(TAM_CABECALHO, 0);
+  std::memcpy(buffer.data(), &cab, sizeof(cab));
+  myfile.seekp(0);
+  myfile.write(buffer.data(), TAM_CABECALHO);
+  return myfile.good();
+}
+
+// Retorna true se o arquivo comeca com a identificacao do formato binario
+bool CircuitoCompilado::ehBinario(const std::string& arq)
+{
+  std::ifstream myfile(arq, std::ios::binary);
+  char magica[sizeof(MAGICA_BINARIO)];
+  if (!myfile.read(magica, sizeof(magica))) return false;
+  return std::memcmp(magica, MAGICA_BINARIO, sizeof(magica))==0;
+}
+
+// Le a representacao compilada de um arquivo binario, sem copiar os vetores
+bool CircuitoCompilado::lerBinario(const std::string& arq)
+{
+  auto A = std::make_shared<ArquivoMapeado>();
+  if (!A->abrir(arq) || A->getTamanho() < TAM_CABECALHO) return false;
+  const char* base = A->getDados();
+
+  // Cabecalho: formato, versao, dimensoes e tamanho
+  CabecalhoBinario cab;
+  std::memcpy(&cab, base, sizeof(cab));
+  if (std::memcmp(cab.magica, MAGICA_BINARIO, sizeof(cab.magica))!=0 ||
+      cab.versao!=VERSAO_BINARIO || cab.ordemBytes!=ORDEM_BYTES_BINARIO) return false;
+  if (cab.tamanho!=A->getTamanho() || cab.tamanho%ALINHAMENTO_BINARIO!=0) return false;
+  if (cab.NI<=0 || cab.NO<=0 || cab.NP<=0 || cab.Nconexoes<0 || cab.Nlacos<0 ||
+      cab.Nlacos>cab.NP || cab.Nniveis<1 || cab.Nniveis-1>cab.NP) return false;
+  if ((long long)cab.NI+cab.NP > INT_MAX) return false;
+  const int NI = cab.NI, NP = cab.NP, NS = cab.NI+cab.NP;
+
+  // Secoes: posicoes alinhadas e dentro do arquivo
+  const size_t elementos[NUM_SECOES] =
+  {
+    size_t(NP), size_t(NP)+1, size_t(cab.Nconexoes), size_t(cab.NO), size_t(NS)+1,
+    size_t(cab.Nconexoes), size_t(NP), size_t(cab.Nlacos), size_t(cab.Nlacos), size_t(NP)
+  };
+  for (int k=0; k<NUM_SECOES; ++k)
+  {
+    size_t tam = (k==SEC_TIPO ? sizeof(TipoPorta) : sizeof(int));
+    if (cab.secao[k]%ALINHAMENTO_BINARIO!=0 || cab.secao[k]<TAM_CABECALHO ||
+        cab.secao[k]>cab.tamanho || elementos[k] > (cab.tamanho-cab.secao[k])/tam) return false;
+  }
+
+  // Soma de verificacao (do cabecalho, com o campo da soma igual a 0, e das secoes)
+  std::vector<char> cabecalho(base, base+TAM_CABECALHO);
+  std::memset(cabecalho.data()+offsetof(CabecalhoBinario, verificacao), 0, sizeof(uint64_t));
+  SomaVerificacao soma;
+  soma.acrescentar(cabecalho.data(), TAM_CABECALHO);
+  soma.acrescentar(base+TAM_CABECALHO, cab.tamanho-TAM_CABECALHO);
+  if (soma.valor()!=cab.verificacao) return false;
+
+  // Os vetores, diretamente no arquivo
+  auto vetor = [&](int k) { return reinterpret_cast<const int*>(base+cab.secao[k]); };
+  const TipoPorta* tp = reinterpret_cast<const TipoPorta*>(base+cab.secao[SEC_TIPO]);
+  const int* ini = vetor(SEC_INI_IN);
+  const int* orig = vetor(SEC_SINAL_IN);
+  const int* saidas = vetor(SEC_SINAL_OUT);
+  const int* ini_fo = vetor(SEC_INI_FANOUT);
+  const int* fo = vetor(SEC_FANOUT);
+  const int* ord = vetor(SEC_ORDEM);
+  const int* ini_l = vetor(SEC_INI_LACO);
+  const int* fim_l = vetor(SEC_FIM_LACO);
+  const int* niv = vetor(SEC_NIVEL);
+  int i, k;
+
+  // Conferencia de todos os indices usados pela simulacao
+  if (ini[0]!=0 || ini[NP]!=cab.Nconexoes || ini_fo[0]!=0 || ini_fo[NS]!=cab.Nconexoes)
+    return false;
+  for (i=0; i<NP; ++i)
+  {
+    if (uint8_t(tp[i])>uint8_t(TipoPorta::NX)) return false;
+    int N = ini[i+1]-ini[i];
+    if (ini[i+1]<ini[i] || (tp[i]==TipoPorta::NT ? N!=1 : N<2)) return false;
+    if (ord[i]<0 || ord[i]>=NP || niv[i]<1 || niv[i]>=cab.Nniveis) return false;
+  }
+  for (k=0; k<cab.Nconexoes; ++k)
+  {
+    if (orig[k]<0 || orig[k]>=NS || fo[k]<0 || fo[k]>=NP) return false;
+  }
+  for (k=0; k<cab.NO; ++k)
+  {
+    if (saidas[k]<0 || saidas[k]>=NS) return false;
+  }
+  for (i=0; i<NS; ++i)
+  {
+    if (ini_fo[i+1]<ini_fo[i]) return false;
+  }
+  for (k=0; k<cab.Nlacos; ++k)
+  {
+    if (ini_l[k]<0 || ini_l[k]>=fim_l[k] || fim_l[k]>NP) return false;
+  }
+  if ((cab.Nlacos>0) != (cab.com_ciclo!=0)) return false;
+
+  // O novo circuito compilado usa os vetores do arquivo, que fica mapeado enquanto
+  // algum vetor apontar para ele. Soh eh aceito se a estrutura for coerente.
+  CircuitoCompilado novo;
+  novo.Nin_circ = NI;
+  novo.tipo.externo(A, tp, NP);
+  novo.ini_in.externo(A, ini, size_t(NP)+1);
+  novo.sinal_in.externo(A, orig, cab.Nconexoes);
+  novo.sinal_out.externo(A, saidas, cab.NO);
+  novo.ini_fanout.externo(A, ini_fo, size_t(NS)+1);
+  novo.fanout.externo(A, fo, cab.Nconexoes);
+  novo.ordem.externo(A, ord, NP);
+  novo.ini_laco.externo(A, ini_l, cab.Nlacos);
+  novo.fim_laco.externo(A, fim_l, cab.Nlacos);
+  novo.nivel.externo(A, niv, NP);
+  novo.com_ciclo = (cab.com_ciclo!=0);
+  novo.Nniveis = cab.Nniveis;
+  if (!novo.estruturaCoerente()) return false;
+  novo.valor.assign(NS, bool3S::UNDEF);
+
+  *this = std::move(novo);
+  return true;
+}
@@ -0,0 +1,515 @@
+#ifndef _CIRCUITOCOMPILADO_H_
+#define _CIRCUITOCOMPILADO_H_
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <string>
+#include "bool3S.h"
+#include "bool3S64.h"
+#include "porta.h"
+#include "arenaportas.h"
+#include "kernelsimd.h"
+
+/// ###########################################################################
+/// REPRESENTACAO COMPILADA (SOMENTE LEITURA) DE UM CIRCUITO
+///
+/// As portas e a conectividade ficam em vetores contiguos (formato CSR), sem
+/// ponteiros nem objetos polimorficos. Os sinais sao numerados sequencialmente:
+/// - sinais de 0 a NI-1: entradas do circuito (id -1 -> sinal 0, id -2 -> sinal 1, ...)
+/// - sinais de NI a NI+NP-1: saidas das portas (id 1 -> sinal NI, id 2 -> sinal NI+1, ...)
+/// Assim, as origens das entradas das portas e das saidas do circuito sao indices
+/// diretos no vetor de valores dos sinais.
+/// ###########################################################################
+
+///
+/// VETOR COMPILADO
+///
+/// Um vetor somente leitura da representacao compilada. Os dados podem pertencer
+/// ao proprio vetor (quando o circuito eh compilado) ou estar em uma area de memoria
+/// externa, mantida viva pelo vetor (quando o circuito eh lido de um arquivo binario
+/// mapeado na memoria: os dados sao usados diretamente no arquivo, sem copia).
+/// O acesso eh sempre por um ponteiro direto, sem testes.
+///
+
+template <class T>
+class VetorCompilado
+{
+private:
+  // Os dados proprios (vazio se os dados forem externos)
+  std::vector<T> proprios;
+  // O dono da memoria externa (nullptr se os dados forem proprios)
+  std::shared_ptr<const void> origem;
+  // Os dados (proprios ou externos) e o numero de elementos
+  const T* p;
+  size_t N;
+
+public:
+  // Vetor vazio
+  VetorCompilado(): proprios(), origem(), p(nullptr), N(0) {}
+
+  // Copia: os dados proprios sao copiados; os externos, compartilhados
+  VetorCompilado(const VetorCompilado& V):
+    proprios(V.proprios), origem(V.origem),
+    p(V.origem ? V.p : proprios.data()), N(V.N) {}
+  VetorCompilado(VetorCompilado&& V) noexcept: VetorCompilado()
+  {
+    *this = std::move(V);
+  }
+  VetorCompilado& operator=(const VetorCompilado& V)
+  {
+    if (this!=&V) *this = VetorCompilado(V);
+    return *this;
+  }
+  VetorCompilado& operator=(VetorCompilado&& V) noexcept
+  {
+    // O buffer de um std::vector nao muda de endereco quando ele eh movido
+    proprios = std::move(V.proprios);
+    origem = std::move(V.origem);
+    p = (origem ? V.p : proprios.data());
+    N = V.N;
+    V.clear();
+    return *this;
+  }
+
+  // Passa a usar os elementos de v (dados proprios)
+  VetorCompilado& operator=(std::vector<T>&& v)
+  {
+    proprios = std::move(v);
+    origem.reset();
+    p = proprios.data();
+    N = proprios.size();
+    return *this;
+  }
+
+  // Passa a usar os n elementos externos em dados, que pertencem a "dono"
+  void externo(std::shared_ptr<const void> dono, const T* dados, size_t n)
+  {
+    proprios = std::vector<T>();
+    origem = std::move(dono);
+    p = dados;
+    N = n;
+  }
+
+  // Esvazia o vetor
+  void clear() noexcept
+  {
+    proprios = std::vector<T>();
+    origem.reset();
+    p = nullptr;
+    N = 0;
+  }
+
+  size_t size() const
+  {
+    return N;
+  }
+  bool empty() const
+  {
+    return N==0;
+  }
+  const T* data() const
+  {
+    return p;
+  }
+  const T& operator[](size_t i) const
+  {
+    return p[i];
+  }
+  const T* begin() const
+  {
+    return p;
+  }
+  const T* end() const
+  {
+    return p+N;
+  }
+};
+
+///
+/// CONE DE INFLUENCIA
+///
+/// As portas e as entradas do circuito das quais dependem algumas das saidas.
+/// Para calcular apenas essas saidas, basta simular as portas do cone.
+///
+
+struct ConeInfluencia
+{
+  // Indices (em ordem crescente) das saidas do circuito que definem o cone
+  std::vector<int> saidas;
+  // Indices (em ordem crescente) das entradas do circuito das quais as saidas dependem
+  std::vector<int> entradas;
+  // Indices das portas do cone, na ordem topologica do circuito
+  std::vector<int> ordem;
+  // Os lacos do cone: as portas do laco c sao ordem[ini_laco[c]] ... ordem[fim_laco[c]-1]
+  std::vector<int> ini_laco;
+  std::vector<int> fim_laco;
+};
+
+class CircuitoCompilado
+{
+private:
+  /// ***********************
+  /// Dados
+  /// ***********************
+
+  // Numero de entradas do circuito
+  int Nin_circ;
+
+  // Tipo de cada porta (dimensao NP)
+  VetorCompilado<TipoPorta> tipo;
+
+  // Conectividade das portas em formato CSR:
+  // as origens das entradas da porta de indice i (id=i+1) sao os sinais
+  // sinal_in[ini_in[i]] ... sinal_in[ini_in[i+1]-1]
+  VetorCompilado<int> ini_in;   // dimensao NP+1
+  VetorCompilado<int> sinal_in; // dimensao igual ao numero total de conexoes
+
+  // Sinal de origem de cada saida do circuito (dimensao NO)
+  VetorCompilado<int> sinal_out;
+
+  // Listas (CSR) das portas que recebem cada sinal (fanout):
+  // as portas que recebem o sinal s sao fanout[ini_fanout[s]] ... fanout[ini_fanout[s+1]-1]
+  VetorCompilado<int> ini_fanout; // dimensao NI+NP+1
+  VetorCompilado<int> fanout;     // dimensao igual ao numero total de conexoes
+
+  // Indices de todas as portas em ordem topologica das componentes fortemente
+  // conexas (algoritmo de Tarjan): se a porta i influencia a porta j e as duas nao
+  // estao no mesmo laco, i aparece antes de j. As portas de um mesmo laco ficam
+  // em posicoes consecutivas (dimensao NP).
+  VetorCompilado<int> ordem;
+  // Os lacos combinacionais: as componentes fortemente conexas com realimentacao
+  // (mais de uma porta, ou uma porta ligada a si mesma).
+  // As portas do laco c sao ordem[ini_laco[c]] ... ordem[fim_laco[c]-1]
+  VetorCompilado<int> ini_laco;
+  VetorCompilado<int> fim_laco;
+  // true se o circuito tem algum laco combinacional
+  bool com_ciclo;
+  // Nivel de cada porta na ordem topologica (dimensao NP) e numero de niveis
+  // (as entradas do circuito estao no nivel 0; as portas, de 1 a Nniveis-1).
+  // Todas as portas de um laco tem o mesmo nivel.
+  VetorCompilado<int> nivel;
+  int Nniveis;
+
+  // Valores logicos atuais de todos os sinais (dimensao NI+NP)
+  std::vector<bool3S> valor;
+  // true se valor contem o resultado completo de uma simulacao anterior
+  // (condicao para a simulacao dirigida por eventos)
+  bool estado_valido;
+
+  // Estado da simulacao dirigida por eventos:
+  // marca das portas jah agendadas (dimensao NP) e filas de portas agendadas por nivel
+  std::vector<char> agendada;
+  std::vector< std::vector<int> > eventos;
+  // Valores logicos atuais de todos os sinais na simulacao bit-paralela
+  // (64 vetores de entrada simultaneos; dimensao NI+NP)
+  std::vector<bool3S_64> valor64;
+  // Valores logicos atuais de todos os sinais na simulacao vetorial
+  // (BOOL3S_BLOCO vetores de entrada simultaneos; dimensao NI+NP)
+  std::vector<bool3S_bloco> valorBloco;
+  // Valores logicos atuais de todos os sinais na simulacao binaria (sem UNDEF):
+  // 64 vetores de entrada simultaneos, um bit por vetor (1: TRUE; 0: FALSE); dimensao NI+NP
+  std::vector<uint64_t> valorBinario;
+
+  // Cones de influencia jah calculados, indexados pelos indices das saidas
+  std::map< std::vector<int>, std::shared_ptr<const ConeInfluencia> > cones;
+
+  /// ***********************
+  /// Funcoes auxiliares
+  /// ***********************
+
+  // Calcula as listas de fanout, as componentes fortemente conexas (lacos),
+  // a ordem topologica e os niveis das portas
+  void levelizar();
+
+  // Retorna true se as listas de fanout, a ordem topologica, os lacos e os niveis sao
+  // coerentes com as conexoes (sinal_in), como se tivessem sido calculados por levelizar.
+  // Usada quando esses vetores sao lidos de um arquivo. Supoe os indices jah conferidos.
+  bool estruturaCoerente() const;
+
+  /// ***********************
+  /// Nucleo de simulacao
+  ///
+  /// Escrito uma unica vez, como templates sobre o dominio de valores T dos sinais
+  /// (dominiovalor.h) e sobre a funcao de avaliacao das portas: avaliar(i, V, dest)
+  /// armazena em dest o valor da porta de indice i, a partir dos valores dos sinais em V.
+  /// ***********************
+
+  // Avalia a porta de indice i no dominio T a partir dos valores dos sinais armazenados em V
+  template <class T>
+  T avaliarPorta(int i, const T* V) const
+  {
+    return ::avaliarPorta(tipo[i], V, sinal_in.data()+ini_in[i], ini_in[i+1]-ini_in[i]);
+  }
+
+  // A funcao de avaliacao das portas com a logica generica (::avaliarPorta) no dominio T
+  template <class T>
+  struct AvaliadorGenerico
+  {
+    const CircuitoCompilado* C;
+    void operator()(int i, const T* V, T& dest) const
+    {
+      dest = C->avaliarPorta(i, V);
+    }
+  };
+
+  // Avalia todas as portas (V[0] ... V[NI-1] jah contem as entradas): uma unica vez, na
+  // ordem topologica, nos circuitos sem lacos e nos dominios binarios; com iteracao ateh
+  // o ponto fixo dos lacos nos dominios ternarios
+  template <class T, class Avaliador>
+  void simularCircuito(T* V, Avaliador avaliar) const;
+
+  // Avalia as portas ord[0] ... ord[N-1] (em ordem topologica), uma unica vez as que estao
+  // fora de lacos e iterando ateh o ponto fixo os Nlacos lacos (os trechos
+  // [ini_l[c], fim_l[c]) de ord)
+  template <class T, class Avaliador>
+  void simularOrdem(const int* ord, int N, const int* ini_l, const int* fim_l, int Nlacos,
+                    T* V, Avaliador avaliar) const;
+
+  // Reavalia as portas ainda nao definidas de um laco (portas[0] ... portas[N-1])
+  // ateh que nenhuma mude
+  template <class T, class Avaliador>
+  void simularLaco(const int* portas, int N, T* V, Avaliador avaliar) const;
+
+  // Agenda para reavaliacao (simulacao dirigida por eventos) as portas que recebem o sinal s
+  void agendarFanout(int s);
+
+public:
+  /// ***********************
+  /// Inicializacao e finalizacao
+  /// ***********************
+
+  // Construtor default = circuito compilado vazio
+  CircuitoCompilado();
+
+  // Limpa todo o conteudo
+  void clear() noexcept;
+
+  // Monta a representacao compilada a partir das portas e das conexoes de um circuito
+  // (mesmas convencoes de ids da classe Circuito).
+  // Soh deve ser chamada para circuitos validos.
+  void compilar(int NI, const std::vector<ptr_Porta>& ports, const ConexoesPortas& id_in,
+                const std::vector<int>& id_out);
+
+  /// ***********************
+  /// Funcoes de consulta
+  /// ***********************
+
+  int getNumInputs() const
+  {
+    return Nin_circ;
+  }
+  int getNumOutputs() const
+  {
+    return int(sinal_out.size());
+  }
+  int getNumPorts() const
+  {
+    return int(tipo.size());
+  }
+  // Numero total de sinais (entradas do circuito e saidas de portas)
+  int getNumSinais() const
+  {
+    return Nin_circ+getNumPorts();
+  }
+  // Numero total de conexoes (entradas de portas)
+  int getNumConexoes() const
+  {
+    return int(sinal_in.size());
+  }
+
+  // Retorna true se o circuito tem algum laco combinacional
+  bool possuiCiclo() const
+  {
+    return com_ciclo;
+  }
+
+  // Numero de lacos combinacionais (componentes fortemente conexas com realimentacao)
+  int getNumLacos() const
+  {
+    return int(ini_laco.size());
+  }
+
+  // Indices (em ordem crescente) das portas que formam o laco c (de 0 a getNumLacos()-1)
+  std::vector<int> getPortasLaco(int c) const;
+
+  // Converte uma id de origem (da classe Circuito) para o indice do sinal correspondente
+  int sinal(int IdOrig) const
+  {
+    return (IdOrig>0 ? Nin_circ+IdOrig-1 : -IdOrig-1);
+  }
+  // Converte o indice de um sinal para a id de origem correspondente (da classe Circuito)
+  int idOrig(int s) const
+  {
+    return (s>=Nin_circ ? s-Nin_circ+1 : -s-1);
+  }
+
+  // Tipo da porta de indice i
+  TipoPorta getTipoPort(int i) const
+  {
+    return tipo[i];
+  }
+  // Numero de entradas da porta de indice i
+  int getNumInputsPort(int i) const
+  {
+    return ini_in[i+1]-ini_in[i];
+  }
+  // Sinal de origem da k-esima entrada (k de 0 a getNumInputsPort(i)-1) da porta de indice i
+  int getSinalInPort(int i, int k) const
+  {
+    return sinal_in[ini_in[i]+k];
+  }
+  // Sinal de origem da saida do circuito de indice j
+  int getSinalOutCirc(int j) const
+  {
+    return sinal_out[j];
+  }
+  // Indices de todas as portas em ordem topologica (as portas de um laco ficam consecutivas)
+  const VetorCompilado<int>& getOrdem() const
+  {
+    return ordem;
+  }
+
+  // Valor logico atual da saida da porta de indice i (id=i+1)
+  bool3S getOutputPort(int i) const
+  {
+    return valor[Nin_circ+i];
+  }
+
+  // Valor logico atual da saida do circuito de indice i (id=i+1)
+  bool3S getOutputCirc(int i) const
+  {
+    return valor[sinal_out[i]];
+  }
+  // Valor logico da saida do circuito de indice i em um vetor de valores externo
+  // (preenchido pela versao const de simular)
+  bool3S getOutputCirc(int i, const bool3S* V) const
+  {
+    return V[sinal_out[i]];
+  }
+
+  // Os 64 valores logicos atuais (simulacao bit-paralela) da saida da porta
+  // e da saida do circuito de indice i
+  bool3S_64 getOutputPort64(int i) const
+  {
+    return valor64[Nin_circ+i];
+  }
+  bool3S_64 getOutputCirc64(int i) const
+  {
+    return valor64[sinal_out[i]];
+  }
+  // Os 64 valores logicos da saida do circuito de indice i em um vetor de valores externo
+  // (preenchido pela versao const de simular no dominio bool3S_64)
+  bool3S_64 getOutputCirc64(int i, const bool3S_64* V) const
+  {
+    return V[sinal_out[i]];
+  }
+
+  // Os 64 valores logicos atuais (simulacao binaria, um bit por vetor) da saida
+  // do circuito de indice i
+  uint64_t getOutputCircBinario(int i) const
+  {
+    return valorBinario[sinal_out[i]];
+  }
+
+  // Os BOOL3S_BLOCO valores logicos atuais (simulacao vetorial) da saida da porta
+  // e da saida do circuito de indice i
+  const bool3S_bloco& getOutputPortBloco(int i) const
+  {
+    return valorBloco[Nin_circ+i];
+  }
+  const bool3S_bloco& getOutputCircBloco(int i) const
+  {
+    return valorBloco[sinal_out[i]];
+  }
+
+  /// ***********************
+  /// SIMULACAO
+  /// ***********************
+
+  // Calcula os valores de todos os sinais para as entradas in_circ
+  // (vetor com NI valores; nao eh testado).
+  void simular(const bool3S* in_circ);
+
+  // Versao que nao altera o circuito compilado: os valores de todos os sinais sao
+  // armazenados em V (vetor com getNumSinais() valores, fornecido pelo chamador).
+  // Pode ser chamada simultaneamente por varias threads, cada uma com o seu V.
+  // Eh generica no dominio de valores T (dominiovalor.h): bool3S, bool3S_64, bool3S_bloco,
+  // bool ou uint64_t. Nos dominios binarios (bool e uint64_t), soh pode ser usada em
+  // circuitos sem lacos (ver simularBinario).
+  template <class T>
+  void simular(const T* in_circ, T* V) const;
+
+  // Retorna o cone de influencia das saidas de indices "saidas" (que nao sao testados).
+  // O cone eh calculado na primeira vez e guardado para as chamadas seguintes.
+  std::shared_ptr<const ConeInfluencia> getCone(std::vector<int> saidas);
+
+  // Calcula apenas os valores dos sinais do cone K, a partir das entradas in_circ
+  // (vetor com NI valores, dos quais soh sao lidos os das entradas do cone).
+  // Os valores dos demais sinais ficam inalterados (e desatualizados).
+  void simularCone(const ConeInfluencia& K, const bool3S* in_circ);
+  // Versao que nao altera o circuito compilado: os valores dos sinais do cone sao
+  // armazenados em V (vetor com getNumSinais() valores, fornecido pelo chamador).
+  void simularCone(const ConeInfluencia& K, const bool3S* in_circ, bool3S* V) const;
+
+  // Simulacao dirigida por eventos: produz o mesmo resultado que simular, mas
+  // reavalia apenas as portas cujas entradas mudaram desde a ultima simulacao,
+  // propagando as mudancas pelas listas de fanout ateh que as saidas parem de mudar.
+  // Eh vantajosa quando poucas entradas mudam entre vetores consecutivos.
+  // Se nao houver simulacao anterior ou se o circuito tiver lacos, faz a simulacao completa.
+  void simularEventos(const bool3S* in_circ);
+
+  // Simulacao bit-paralela: calcula os valores de todos os sinais para 64 vetores
+  // de entrada simultaneos (in_circ eh um vetor com NI valores bool3S_64; nao eh testado).
+  // O resultado em cada uma das 64 posicoes eh identico ao da funcao simular.
+  void simular64(const bool3S_64* in_circ);
+
+  // Simulacao binaria bit-paralela: calcula os valores de todos os sinais para 64 vetores
+  // de entrada simultaneos sem valores UNDEF. O bit k de in_circ[j] eh o valor da entrada j
+  // no k-esimo vetor (1: TRUE; 0: FALSE). Cada porta eh avaliada com uma unica operacao
+  // logica sobre uint64_t por entrada.
+  // Soh pode ser usada em circuitos sem lacos: com lacos, mesmo entradas definidas podem
+  // produzir UNDEF, e deve ser usada a simulacao ternaria (simular64).
+  void simularBinario(const uint64_t* in_circ);
+
+  // Simulacao vetorial: calcula os valores de todos os sinais para BOOL3S_BLOCO vetores
+  // de entrada simultaneos (in_circ eh um vetor com NI valores bool3S_bloco; nao eh testado).
+  // As portas sao avaliadas com o kernel K; se K==nullptr, usa o melhor kernel da CPU.
+  // O resultado em cada posicao eh identico ao da funcao simular.
+  void simularBloco(const bool3S_bloco* in_circ, KernelPorta K=nullptr);
+
+  /// ***********************
+  /// ARQUIVO BINARIO
+  ///
+  /// Formato binario versionado com os vetores da representacao compilada, inclusive os
+  /// calculados por levelizar (fanout, ordem topologica, lacos e niveis):
+  /// - cabecalho: identificacao do formato, versao, ordem dos bytes, dimensoes do
+  ///   circuito, tamanho do arquivo, posicao de cada secao e soma de verificacao
+  /// - secoes: um vetor por secao, no formato da memoria, cada uma iniciando em uma
+  ///   posicao multipla de 64 bytes (o restante eh preenchido com zeros)
+  /// A soma de verificacao cobre o arquivo inteiro (cabecalho e secoes).
+  /// ***********************
+
+  // Salva a representacao compilada no arquivo binario arq.
+  // Retorna false se nao conseguiu escrever o arquivo.
+  bool salvarBinario(const std::string& arq) const;
+
+  // Le a representacao compilada do arquivo binario arq. O arquivo eh mapeado na memoria
+  // e os vetores compilados apontam diretamente para as secoes do arquivo: nao ha copia
+  // dos dados nem alocacao por porta, e nao eh preciso levelizar (apenas os vetores de
+  // valores dos sinais sao alocados). O mapeamento eh desfeito quando nenhuma copia
+  // deste circuito compilado o usar mais.
+  // Alem da soma de verificacao, sao conferidos todos os indices e a coerencia dos vetores
+  // calculados por levelizar com as conexoes (estruturaCoerente): um arquivo corrompido,
+  // mesmo com uma soma de verificacao correta, eh rejeitado, em vez de simular errado.
+  // A conferencia percorre cada vetor uma vez, sem ordenar nem levelizar.
+  // Se o arquivo for invalido, nao altera o circuito compilado e retorna false.
+  bool lerBinario(const std::string& arq);
+
+  // Retorna true se o arquivo arq comeca com a identificacao do formato binario (mesmo
+  // que o restante seja invalido): permite escolher entre lerBinario e a leitura do
+  // formato texto antes de ler o arquivo.
+  static bool ehBinario(const std::string& arq);
+};
+
+#endif // _CIRCUITOCOMPILADO_H_
@@ -0,0 +1,119 @@
+#ifndef _DOMINIOVALOR_H_
+#define _DOMINIOVALOR_H_
+
+#include <cstdint>
+#include "bool3S.h"
+#include "bool3S64.h"
+
+/// ###########################################################################
+/// DOMINIOS DE VALORES DOS SINAIS
+///
+/// A logica das portas (avaliarPorta, em porta.h) e o nucleo de simulacao
+/// (CircuitoCompilado) sao escritos uma unica vez, como templates sobre o tipo T
+/// dos valores dos sinais. Cada dominio define, em DominioValor<T>:
+/// - ternario: true se o dominio tem o valor UNDEF (pode simular lacos)
+/// - indefinido(): o valor inicial das portas de um laco (UNDEF em todas as posicoes)
+/// - nao: o operador NOT; e, ou, xou: os operadores AND, OR e XOR, acumulados
+///   no primeiro operando (x1 = x1 AND x2, etc.)
+/// - absorveE, absorveOu, absorveXou: true se o valor, sozinho, jah define a saida
+///   da porta correspondente (curto-circuito; soh nos dominios escalares)
+/// - definido(x): true se todas as posicoes de x sao definidas (o valor de uma
+///   porta definida nao muda mais na iteracao de um laco)
+///
+/// Os dominios sao:
+/// - bool3S: um valor ternario (simulacao escalar)
+/// - bool3S_64: 64 valores ternarios (simulacao bit-paralela)
+/// - bool3S_bloco: BOOL3S_BLOCO valores ternarios (simulacao vetorial)
+/// - bool: um valor binario (circuitos sem lacos)
+/// - uint64_t: 64 valores binarios, um por bit (circuitos sem lacos)
+/// ###########################################################################
+
+template <class T>
+struct DominioValor;
+
+// Um valor bool3S
+template <>
+struct DominioValor<bool3S>
+{
+  static constexpr bool ternario = true;
+  static bool3S indefinido() { return bool3S::UNDEF; }
+  static bool3S nao(bool3S x) { return ~x; }
+  static void e(bool3S& x1, bool3S x2) { x1 &= x2; }
+  static void ou(bool3S& x1, bool3S x2) { x1 |= x2; }
+  static void xou(bool3S& x1, bool3S x2) { x1 ^= x2; }
+  static bool absorveE(bool3S x) { return x==bool3S::FALSE; }
+  static bool absorveOu(bool3S x) { return x==bool3S::TRUE; }
+  static bool absorveXou(bool3S x) { return x==bool3S::UNDEF; }
+  static bool definido(bool3S x) { return x!=bool3S::UNDEF; }
+};
+
+// 64 valores bool3S (dual-rail)
+template <>
+struct DominioValor<bool3S_64>
+{
+  static constexpr bool ternario = true;
+  static bool3S_64 indefinido() { return toBool3S_64(bool3S::UNDEF); }
+  static bool3S_64 nao(bool3S_64 x) { return ~x; }
+  static void e(bool3S_64& x1, bool3S_64 x2) { x1 &= x2; }
+  static void ou(bool3S_64& x1, bool3S_64 x2) { x1 |= x2; }
+  static void xou(bool3S_64& x1, bool3S_64 x2) { x1 ^= x2; }
+  static bool absorveE(bool3S_64) { return false; }
+  static bool absorveOu(bool3S_64) { return false; }
+  static bool absorveXou(bool3S_64) { return false; }
+  static bool definido(bool3S_64 x) { return (x.t|x.f)==~uint64_t(0); }
+};
+
+// BOOL3S_BLOCO valores bool3S (dual-rail, vetorial)
+template <>
+struct DominioValor<bool3S_bloco>
+{
+  static constexpr bool ternario = true;
+  static bool3S_bloco indefinido() { return toBool3S_bloco(bool3S::UNDEF); }
+  static bool3S_bloco nao(const bool3S_bloco& x) { return ~x; }
+  static void e(bool3S_bloco& x1, const bool3S_bloco& x2) { x1 &= x2; }
+  static void ou(bool3S_bloco& x1, const bool3S_bloco& x2) { x1 |= x2; }
+  static void xou(bool3S_bloco& x1, const bool3S_bloco& x2) { x1 ^= x2; }
+  static bool absorveE(const bool3S_bloco&) { return false; }
+  static bool absorveOu(const bool3S_bloco&) { return false; }
+  static bool absorveXou(const bool3S_bloco&) { return false; }
+  static bool definido(const bool3S_bloco& x)
+  {
+    uint64_t def = ~uint64_t(0);
+    for (int w=0; w<PALAVRAS_BLOCO; ++w) def &= (x.t[w] | x.f[w]);
+    return def==~uint64_t(0);
+  }
+};
+
+// Um valor binario (true: TRUE; false: FALSE)
+template <>
+struct DominioValor<bool>
+{
+  static constexpr bool ternario = false;
+  static bool indefinido() { return false; }
+  static bool nao(bool x) { return !x; }
+  static void e(bool& x1, bool x2) { x1 = x1 && x2; }
+  static void ou(bool& x1, bool x2) { x1 = x1 || x2; }
+  static void xou(bool& x1, bool x2) { x1 = x1 != x2; }
+  static bool absorveE(bool x) { return !x; }
+  static bool absorveOu(bool x) { return x; }
+  static bool absorveXou(bool) { return false; }
+  static bool definido(bool) { return true; }
+};
+
+// 64 valores binarios, um por bit (1: TRUE; 0: FALSE)
+template <>
+struct DominioValor<uint64_t>
+{
+  static constexpr bool ternario = false;
+  static uint64_t indefinido() { return 0; }
+  static uint64_t nao(uint64_t x) { return ~x; }
+  static void e(uint64_t& x1, uint64_t x2) { x1 &= x2; }
+  static void ou(uint64_t& x1, uint64_t x2) { x1 |= x2; }
+  static void xou(uint64_t& x1, uint64_t x2) { x1 ^= x2; }
+  static bool absorveE(uint64_t) { return false; }
+  static bool absorveOu(uint64_t) { return false; }
+  static bool absorveXou(uint64_t) { return false; }
+  static bool definido(uint64_t) { return true; }
+};
+
+#endif // _DOMINIOVALOR_H_
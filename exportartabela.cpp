@@ -0,0 +1,241 @@
+#include <fstream>
+#include <algorithm>
+#include <vector>
+#include <cctype>
+#include <cstring>
+#include <cstdio>
+#include "exportartabela.h"
+#include "tabelaverdade.h"
+#include "importar.h"
+#include "otimizar.h"
+
+/// ***********************
+/// Funcoes auxiliares
+/// ***********************
+
+// Grava um arquivo em blocos de tamanho fixo: os dados sao acumulados em um buffer e
+// gravados de uma vez quando ele enche, sem as chamadas por caractere da stream.
+// A memoria usada eh soh a do buffer, qualquer que seja o tamanho do arquivo.
+class EscritorBlocos
+{
+private:
+  std::ofstream arq;
+  std::vector<char> buffer;
+  size_t usado;
+
+public:
+  // Tamanho de cada bloco gravado
+  static constexpr size_t TAM_BLOCO = size_t(1) << 20;
+
+  EscritorBlocos(): buffer(TAM_BLOCO), usado(0) {}
+
+  // Cria o arquivo de nome "nome". Retorna false se nao conseguiu criar.
+  bool abrir(const std::string& nome)
+  {
+    arq.open(nome, std::ios::binary);
+    usado = 0;
+    return arq.is_open();
+  }
+
+  // Acrescenta um caractere
+  void escrever(char c)
+  {
+    if (usado==buffer.size()) descarregar();
+    buffer[usado++] = c;
+  }
+
+  // Acrescenta N caracteres
+  void escrever(const char* s, size_t N)
+  {
+    while (N>0)
+    {
+      if (usado==buffer.size()) descarregar();
+      size_t k = std::min(N, buffer.size()-usado);
+      std::memcpy(buffer.data()+usado, s, k);
+      usado += k;
+      s += k;
+      N -= k;
+    }
+  }
+  void escrever(const std::string& s)
+  {
+    escrever(s.data(), s.size());
+  }
+
+  // Grava o conteudo do buffer no arquivo e o esvazia.
+  // Retorna false se houve algum erro de gravacao.
+  bool descarregar()
+  {
+    if (usado>0) arq.write(buffer.data(), std::streamsize(usado));
+    usado = 0;
+    return arq.good();
+  }
+
+  // Retorna false se houve algum erro de gravacao
+  bool ok() const
+  {
+    return arq.good();
+  }
+
+  // Grava o que falta e fecha o arquivo. Retorna false se houve algum erro de gravacao.
+  bool fechar()
+  {
+    bool ok = descarregar();
+    arq.close();
+    return ok && !arq.fail();
+  }
+};
+
+// Grava o cabecalho do formato binario da tabela verdade
+static void escreverCabecalho(EscritorBlocos& E, int NI, int NO, bool binaria)
+{
+  CabecalhoTabela cab;
+  std::memset(&cab, 0, sizeof(cab));
+  std::memcpy(cab.magica, "TABVERD\x1A", sizeof(cab.magica));
+  cab.versao = VERSAO_TABELA;
+  cab.ordemBytes = 0x01020304;
+  cab.NI = NI;
+  cab.NO = NO;
+  cab.binaria = (binaria ? 1 : 0);
+  cab.Nlinhas = uint64_t(binaria ? numLinhasTabelaBinaria(NI) : numLinhasTabela(NI));
+
+  char bloco[TAM_CABECALHO_TABELA] = {0};
+  std::memcpy(bloco, &cab, sizeof(cab));
+  E.escrever(bloco, TAM_CABECALHO_TABELA);
+}
+
+/// ***********************
+/// Exportacao
+/// ***********************
+
+// Retorna o formato correspondente aa extensao do nome do arquivo
+FormatoTabela formatoPorExtensao(const std::string& arq)
+{
+  size_t ponto = arq.rfind('.');
+  if (ponto==std::string::npos) return FormatoTabela::BINARIO;
+  std::string ext = arq.substr(ponto+1);
+  for (char& c : ext) c = char(tolower((unsigned char)c));
+  return (ext=="csv" ? FormatoTabela::CSV : FormatoTabela::BINARIO);
+}
+
+// Gera a tabela verdade do circuito C e a grava no arquivo arq
+bool exportarTabela(Circuito& C, const std::string& arq, FormatoTabela formato,
+                    bool binaria, PoolTrabalho* P, const NomesCircuito* nomes,
+                    const ProgressoTabela& progresso)
+{
+  if (!C.valid()) return false;
+  const int NI = C.getNumInputs();
+  const int NO = C.getNumOutputs();
+  if (binaria ? NI>MAX_ENTRADAS_BINARIA : NI>MAX_ENTRADAS_TABELA) return false;
+
+  // A tabela de nomes soh vale se as dimensoes forem as do circuito
+  const bool comNomes = (nomes!=nullptr && int(nomes->entradas.size())==NI &&
+                         int(nomes->saidas.size())==NO);
+  // Indice da entrada das constantes (NomesCircuito::entradaConstante), ou -1 se nao
+  // houver. Ela nao faz parte da tabela: soh as linhas em que ela eh TRUE sao gravadas,
+  // sem a sua coluna. Como ela eh um digito do numero da linha, as linhas restantes
+  // continuam na ordem canonica das demais entradas. O circuito eh antes simplificado
+  // com ela fixada em TRUE, o que elimina as portas que as constantes tornam constantes.
+  const int cte = (comNomes && nomes->entradaConstante<0 && -nomes->entradaConstante<=NI ?
+                   -nomes->entradaConstante-1 : -1);
+  const int Ntabela = (cte>=0 ? NI-1 : NI);
+  ResultadoOtimizacao R;
+  if (cte>=0 && !simplificar(C, std::vector<int>(1, -cte-1),
+                             std::vector<bool3S>(1, bool3S::TRUE), R)) return false;
+  Circuito& G = (cte>=0 ? R.circ : C);
+
+  EscritorBlocos E;
+  if (!E.abrir(arq)) return false;
+
+  ReceptorLinha receptor;
+  // Estado do empacotamento do formato binario: byte em formacao e numero de valores nele
+  unsigned char byte = 0;
+  int Nvalores = 0;
+
+  if (formato==FormatoTabela::CSV)
+  {
+    // Linha com os nomes das colunas
+    bool primeira = true;
+    for (int i=0; i<NI; ++i)
+    {
+      if (i==cte) continue;
+      if (!primeira) E.escrever(',');
+      E.escrever(comNomes ? nomes->entradas[i] : "E" + std::to_string(i+1));
+      primeira = false;
+    }
+    for (int j=0; j<NO; ++j)
+    {
+      E.escrever(',');
+      E.escrever(comNomes ? nomes->saidas[j] : "S" + std::to_string(j+1));
+    }
+    E.escrever('\n');
+
+    // Cada linha: entradas e saidas (T, F ou ?) separadas por virgulas
+    receptor = [&](long long, const bool3S* in, const bool3S* out)
+    {
+      for (int i=0; i<NI; ++i)
+      {
+        if (i==cte) continue;
+        E.escrever(toChar(in[i]));
+        E.escrever(',');
+      }
+      for (int j=0; j<NO; ++j)
+      {
+        E.escrever(toChar(out[j]));
+        E.escrever(j+1<NO ? ',' : '\n');
+      }
+      // Um erro de gravacao interrompe a geracao
+      return E.ok();
+    };
+  }
+  else
+  {
+    escreverCabecalho(E, Ntabela, NO, binaria);
+
+    // Cada linha: as saidas, 2 bits por valor, em sequencia continua
+    receptor = [&](long long, const bool3S*, const bool3S* out)
+    {
+      for (int j=0; j<NO; ++j)
+      {
+        byte |= (unsigned char)((unsigned(out[j]) & 3u) << (2*Nvalores));
+        if (++Nvalores==4)
+        {
+          E.escrever(char(byte));
+          byte = 0;
+          Nvalores = 0;
+        }
+      }
+      // Um erro de gravacao interrompe a geracao
+      return E.ok();
+    };
+  }
+
+  // Descarta as linhas em que a entrada das constantes nao eh TRUE e, com acompanhamento,
+  // o chama a cada INTERVALO_PROGRESSO linhas gravadas
+  const long long total = (binaria ? numLinhasTabelaBinaria(Ntabela) : numLinhasTabela(Ntabela));
+  long long feitas = 0;
+  ReceptorLinha gravar = receptor;
+  if (cte>=0 || progresso)
+  {
+    gravar = [&](long long, const bool3S* in, const bool3S* out)
+    {
+      if (cte>=0 && in[cte]!=bool3S::TRUE) return true;
+      if (!receptor(feitas, in, out)) return false;
+      ++feitas;
+      return (!progresso || feitas%INTERVALO_PROGRESSO!=0 || progresso(feitas, total));
+    };
+  }
+
+  bool gerou;
+  if (binaria) gerou = G.gerarTabelaBinaria(gravar);
+  else if (P!=nullptr) gerou = G.gerarTabela(gravar, *P);
+  else gerou = G.gerarTabela(gravar, OrdemTabela::CANONICA);
+  if (gerou && progresso) gerou = progresso(total, total);
+
+  // Completa o ultimo byte do formato binario
+  if (Nvalores>0) E.escrever(char(byte));
+  bool gravou = E.fechar();
+  // Nao deixa um arquivo incompleto (erro de gravacao ou cancelamento)
+  if (!gravou || !gerou) std::remove(arq.c_str());
+  return gravou && gerou;
+}
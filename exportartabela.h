@@ -0,0 +1,101 @@
+#ifndef _EXPORTARTABELA_H_
+#define _EXPORTARTABELA_H_
+
+#include <string>
+#include <cstdint>
+#include <functional>
+#include "circuito.h"
+
+/// ###########################################################################
+/// EXPORTACAO DA TABELA VERDADE PARA ARQUIVOS
+///
+/// A tabela verdade eh gerada linha a linha (Circuito::gerarTabela) e gravada
+/// no arquivo em blocos de tamanho fixo: nenhuma linha eh guardada e a memoria
+/// usada nao depende do numero de linhas (3^NI ou 2^NI), que pode ser muito
+/// maior do que o que caberia na tela ou na memoria.
+/// As linhas sao gravadas na ordem canonica (numLinhasTabela e
+/// numLinhasTabelaBinaria), que eh a mesma na geracao sequencial e na paralela.
+/// ###########################################################################
+
+class PoolTrabalho;
+struct NomesCircuito;
+
+// Formato do arquivo da tabela verdade
+// - CSV: texto, uma linha por combinacao de entradas, com os valores das entradas e
+//   das saidas (T, F ou ?) separados por virgulas, depois de uma linha com os nomes
+//   das colunas
+// - BINARIO: um cabecalho (CabecalhoTabela) seguido pelos valores das saidas de todas
+//   as linhas, com 2 bits por valor (ver abaixo)
+enum class FormatoTabela
+{
+  CSV,
+  BINARIO
+};
+
+// O formato binario da tabela verdade:
+// - um cabecalho de 64 bytes, que comeca com a estrutura abaixo (o restante eh zero);
+// - os NO valores das saidas de cada linha, linha a linha, com 2 bits por valor
+//   (UNDEF=0, FALSE=1, TRUE=2, como os valores do bool3S): o valor k da sequencia
+//   (k = linha*NO + saida) ocupa os bits 2*(k%4) e 2*(k%4)+1 do byte k/4, e o ultimo
+//   byte eh completado com zeros.
+// Os valores das entradas nao sao gravados: eles sao dados pelo numero da linha na
+// ordem canonica (linhaParaEntradas ou, na tabela binaria, os bits do numero da linha).
+// Os inteiros sao gravados na ordem de bytes da maquina, indicada por ordemBytes.
+struct CabecalhoTabela
+{
+  // Identificacao do formato ("TABVERD" seguido de 0x1A)
+  char magica[8];
+  // Versao do formato (VERSAO_TABELA)
+  uint32_t versao;
+  // 0x01020304, na ordem de bytes da maquina que gravou o arquivo
+  uint32_t ordemBytes;
+  // Numero de entradas e de saidas do circuito
+  int32_t NI;
+  int32_t NO;
+  // 1 se a tabela tem soh as 2^NI linhas sem UNDEF (tabela binaria); 0 se tem as 3^NI
+  uint32_t binaria;
+  uint32_t reservado;
+  // Numero de linhas da tabela
+  uint64_t Nlinhas;
+};
+
+// Versao atual do formato binario da tabela verdade
+constexpr uint32_t VERSAO_TABELA = 1;
+// Tamanho do cabecalho do formato binario, em bytes
+constexpr int TAM_CABECALHO_TABELA = 64;
+
+static_assert(sizeof(CabecalhoTabela)<=TAM_CABECALHO_TABELA, "cabecalho da tabela muito grande");
+
+// Acompanhamento da exportacao: chamada de tempos em tempos (a cada INTERVALO_PROGRESSO
+// linhas gravadas e ao final), sempre na thread que chamou exportarTabela, com o numero
+// de linhas jah gravadas e o total de linhas da tabela.
+// Se retornar false, a exportacao eh cancelada.
+using ProgressoTabela = std::function<bool(long long feitas, long long total)>;
+
+// Numero de linhas gravadas entre duas chamadas do acompanhamento
+constexpr long long INTERVALO_PROGRESSO = 1LL << 16;
+
+// Retorna o formato correspondente aa extensao do nome do arquivo: CSV para ".csv"
+// (sem diferenciar maiusculas e minusculas) e BINARIO para as demais
+FormatoTabela formatoPorExtensao(const std::string& arq);
+
+// Gera a tabela verdade do circuito C e a grava no arquivo arq, no formato pedido.
+// Se binaria==true, soh as 2^NI linhas sem entradas UNDEF (Circuito::gerarTabelaBinaria,
+// que exige NI<=MAX_ENTRADAS_BINARIA); senao, as 3^NI linhas, em paralelo com as
+// threads do pool P (se P!=nullptr), que exigem NI<=MAX_ENTRADAS_TABELA.
+// No formato CSV, as colunas recebem os nomes das entradas e saidas de nomes
+// (se nomes!=nullptr e as dimensoes forem as de C) ou os nomes E1, E2, ..., S1, S2, ...
+// Se nomes indicar a entrada das constantes de um circuito importado
+// (NomesCircuito::entradaConstante), ela eh mantida TRUE e nao faz parte da tabela:
+// as linhas sao as das demais NI-1 entradas, sem a coluna dela no CSV e com NI-1
+// entradas no cabecalho do formato binario. Os limites valem para as NI entradas de C.
+// Se progresso!=nullptr, ele eh chamado durante a gravacao e pode cancela-la.
+// Retorna false se o circuito for invalido, se tiver entradas demais para a tabela
+// pedida, se o arquivo nao puder ser gravado ou se a exportacao for cancelada; nos
+// dois ultimos casos, o arquivo incompleto eh apagado.
+bool exportarTabela(Circuito& C, const std::string& arq, FormatoTabela formato,
+                    bool binaria=false, PoolTrabalho* P=nullptr,
+                    const NomesCircuito* nomes=nullptr,
+                    const ProgressoTabela& progresso=nullptr);
+
+#endif // _EXPORTARTABELA_H_
@@ -0,0 +1,949 @@
+#include <cctype>
+#include "importar.h"
+#include "arquivomapeado.h"
+
+/// ***********************
+/// MONTAGEM DE UM CIRCUITO A PARTIR DE SINAIS COM NOMES
+/// ***********************
+
+// Os sinais sao numerados na ordem em que aparecem pela primeira vez no arquivo
+// (definidos ou usados). Cada sinal eh definido por uma entrada do circuito, pela saida
+// de um flip-flop cortado ou por uma porta. Ao final, as entradas e as portas recebem
+// as suas ids, as conexoes sao convertidas de sinais para ids e o circuito eh montado
+// de uma vez (Circuito::montar).
+class MontadorNetlist
+{
+private:
+  // Como um sinal eh definido
+  enum class Definicao : unsigned char
+  {
+    NENHUMA, ENTRADA, FLIPFLOP, PORTA,
+    // A entrada extra que fornece a constante 1 (ver constante)
+    CONSTANTE
+  };
+
+  // Indice de cada sinal com nome
+  std::unordered_map<std::string, int> indice;
+  // Nome de cada sinal (vazio para os sinais criados pelo importador)
+  std::vector<std::string> nome;
+  // Definicao de cada sinal e indice da entrada, do flip-flop ou da porta que o define
+  std::vector<Definicao> definicao;
+  std::vector<int> numero;
+  // Posicao no arquivo do primeiro uso de cada sinal (para os erros)
+  std::vector<int> linhaUso, colunaUso;
+
+  // As entradas do circuito e as saidas e entradas dos flip-flops (sinais)
+  std::vector<int> entradas;
+  std::vector<int> ffSaida, ffEntrada;
+  // As portas, em formato CSR: tipo, sinal de saida e sinais das entradas
+  std::vector<TipoPorta> tipo;
+  std::vector<int> saidaPorta;
+  std::vector<int> iniIn;
+  std::vector<int> sinalIn;
+  // Os sinais das saidas do circuito
+  std::vector<int> saidas;
+  // O sinal negado de cada sinal que jah foi negado (porta NT compartilhada)
+  std::unordered_map<int, int> negados;
+  // O sinal da entrada extra da constante 1 (-1 enquanto nao for necessario)
+  int um = -1;
+
+public:
+  MontadorNetlist(): iniIn(1, 0) {}
+
+  // Retorna o indice do sinal de nome n, criando-o (ainda sem definicao) se ele nao
+  // existir; (linha, coluna) eh a posicao do uso no arquivo
+  int sinal(const std::string& n, int linha, int coluna)
+  {
+    auto achou = indice.find(n);
+    if (achou!=indice.end()) return achou->second;
+    int s = novoSinal(linha, coluna);
+    nome[s] = n;
+    indice.emplace(n, s);
+    return s;
+  }
+
+  // Cria um sinal sem nome (que nao existe no arquivo)
+  int novoSinal(int linha, int coluna)
+  {
+    nome.emplace_back();
+    definicao.push_back(Definicao::NENHUMA);
+    numero.push_back(-1);
+    linhaUso.push_back(linha);
+    colunaUso.push_back(coluna);
+    return int(nome.size())-1;
+  }
+
+  // Nome do sinal s
+  const std::string& getNome(int s) const
+  {
+    return nome[s];
+  }
+
+  // Retorna true se o sinal s jah foi definido
+  bool definido(int s) const
+  {
+    return definicao[s]!=Definicao::NENHUMA;
+  }
+
+  // O sinal s (ainda nao definido) passa a ser uma entrada do circuito
+  void entrada(int s)
+  {
+    definicao[s] = Definicao::ENTRADA;
+    numero[s] = int(entradas.size());
+    entradas.push_back(s);
+  }
+
+  // O sinal s passa a ser uma saida do circuito
+  void saida(int s)
+  {
+    saidas.push_back(s);
+  }
+
+  // O sinal q (ainda nao definido) eh a saida de um flip-flop cuja entrada eh o sinal d.
+  // O flip-flop eh cortado: q vira uma entrada e d, uma saida do circuito.
+  void flipflop(int q, int d)
+  {
+    definicao[q] = Definicao::FLIPFLOP;
+    numero[q] = int(ffSaida.size());
+    ffSaida.push_back(q);
+    ffEntrada.push_back(d);
+  }
+
+  // O sinal s (ainda nao definido) passa a ser a saida de uma porta do tipo T cujas
+  // entradas sao os sinais in[0] ... in[N-1] (N>=1). Como nao ha portas de uma entrada
+  // so (exceto NT), uma porta com uma entrada vira NT (se for negada) ou AN com a
+  // mesma origem nas duas entradas (se nao for).
+  void porta(int s, TipoPorta T, const int* in, int N)
+  {
+    definicao[s] = Definicao::PORTA;
+    numero[s] = int(tipo.size());
+    if (N==1 && T!=TipoPorta::NT)
+    {
+      bool negada = (T==TipoPorta::NA || T==TipoPorta::NO || T==TipoPorta::NX);
+      T = (negada ? TipoPorta::NT : TipoPorta::AN);
+    }
+    tipo.push_back(T);
+    saidaPorta.push_back(s);
+    sinalIn.insert(sinalIn.end(), in, in+N);
+    if (N==1 && T==TipoPorta::AN) sinalIn.push_back(in[0]);
+    iniIn.push_back(int(sinalIn.size()));
+  }
+
+  // Retorna um sinal sem nome igual ao sinal s negado. A porta NT eh criada no primeiro
+  // pedido e reaproveitada nos seguintes.
+  int negado(int s)
+  {
+    auto achou = negados.find(s);
+    if (achou!=negados.end()) return achou->second;
+    int n = novoSinal(0, 0);
+    porta(n, TipoPorta::NT, &s, 1);
+    negados.emplace(s, n);
+    return n;
+  }
+
+  // O sinal s (ainda nao definido) passa a ser a constante v. Nao ha portas constantes
+  // e nenhuma combinacao de portas eh constante quando as suas entradas sao UNDEF, entao
+  // a constante vem de uma entrada extra do circuito, de nome NOME_CONSTANTE, que deve
+  // ser mantida TRUE (ver NomesCircuito::entradaConstante): s eh um buffer dessa
+  // entrada (v==true) ou o seu inverso (v==false).
+  void constante(int s, bool v)
+  {
+    if (um<0)
+    {
+      um = novoSinal(0, 0);
+      nome[um] = NOME_CONSTANTE;
+      definicao[um] = Definicao::CONSTANTE;
+    }
+    porta(s, v ? TipoPorta::AN : TipoPorta::NT, &um, 1);
+  }
+
+  // Monta o circuito C e, se nomes!=nullptr, a tabela de nomes.
+  // Se algum sinal usado nao tiver sido definido ou se o circuito for invalido (sem
+  // entradas, saidas ou portas), nao altera C e retorna false, preenchendo *erro.
+  bool montar(Circuito& C, NomesCircuito* nomes, ErroLeitura* erro) const
+  {
+    const int NI = int(entradas.size());
+    const int NF = int(ffSaida.size());
+    // A entrada da constante fica entre as entradas do arquivo e as dos flip-flops
+    const int NC = (um>=0 ? 1 : 0);
+
+    // Id de origem de cada sinal
+    std::vector<int> id(nome.size());
+    for (int s=0; s<int(nome.size()); ++s)
+    {
+      switch (definicao[s])
+      {
+      case Definicao::NENHUMA:
+        if (erro!=nullptr)
+          *erro = ErroLeitura{linhaUso[s], colunaUso[s], "sinal " + nome[s] + " nao definido"};
+        return false;
+      case Definicao::ENTRADA:
+        id[s] = -numero[s]-1;
+        break;
+      case Definicao::FLIPFLOP:
+        id[s] = -(NI+NC+numero[s])-1;
+        break;
+      case Definicao::PORTA:
+        id[s] = numero[s]+1;
+        break;
+      case Definicao::CONSTANTE:
+        id[s] = -NI-1;
+        break;
+      }
+    }
+
+    std::vector<int> idIn(sinalIn.size());
+    for (size_t k=0; k<sinalIn.size(); ++k) idIn[k] = id[sinalIn[k]];
+    std::vector<int> idOut;
+    idOut.reserve(saidas.size()+NF);
+    for (int s : saidas) idOut.push_back(id[s]);
+    for (int s : ffEntrada) idOut.push_back(id[s]);
+
+    if (!C.montar(NI+NC+NF, tipo, iniIn, idIn, idOut))
+    {
+      if (erro!=nullptr)
+        *erro = ErroLeitura{0, 0, "circuito invalido (sem entradas, saidas ou portas)"};
+      return false;
+    }
+
+    if (nomes!=nullptr)
+    {
+      nomes->clear();
+      for (int s : entradas) nomes->entradas.push_back(nome[s]);
+      if (um>=0) nomes->entradas.push_back(NOME_CONSTANTE);
+      for (int s : ffSaida) nomes->entradas.push_back(nome[s]);
+      for (int s : saidas) nomes->saidas.push_back(nome[s]);
+      for (int s : ffEntrada) nomes->saidas.push_back(nome[s]);
+      for (int s : saidaPorta) nomes->portas.push_back(nome[s]);
+      nomes->ids.reserve(indice.size());
+      for (const auto& par : indice) nomes->ids.emplace(par.first, id[par.second]);
+      if (um>=0) nomes->ids.emplace(NOME_CONSTANTE, -NI-1);
+      nomes->Nflipflops = NF;
+      nomes->entradaConstante = (um>=0 ? -NI-1 : 0);
+    }
+    return true;
+  }
+};
+
+// Converte s para maiusculas
+static std::string maiusculas(std::string s)
+{
+  for (char& c : s) c = char(toupper((unsigned char)c));
+  return s;
+}
+
+/// ***********************
+/// FORMATO .BENCH (ISCAS)
+/// ***********************
+
+// Importa um circuito no formato .bench
+bool importarBench(const std::string& arq, Circuito& C, NomesCircuito* nomes, ErroLeitura* erro)
+{
+  ArquivoMapeado A;
+  if (!A.abrir(arq))
+  {
+    if (erro!=nullptr) *erro = ErroLeitura{0, 0, "nao foi possivel abrir o arquivo " + arq};
+    return false;
+  }
+  LeitorTexto L(A.getDados(), A.getTamanho());
+  // Registra um erro na posicao (linha, coluna) e retorna false
+  auto falhaEm = [erro](int linha, int coluna, const std::string& msg)
+  {
+    if (erro!=nullptr) *erro = ErroLeitura{linha, coluna, msg};
+    return false;
+  };
+  // Registra um erro na posicao do ultimo elemento lido e retorna false
+  auto falha = [&L, &falhaEm](const std::string& msg)
+  {
+    return falhaEm(L.getLinha(), L.getColuna(), msg);
+  };
+
+  // Os caracteres que separam os nomes dos sinais
+  const char* DELIM = "()=,#";
+  MontadorNetlist M;
+  std::string nome, palavra;
+  std::vector<int> in;
+
+  while (true)
+  {
+    // Pula os comentarios
+    char c = L.espiar();
+    if (c=='\0')
+    {
+      // Fim do texto ou um caractere nulo no meio do arquivo
+      if (L.acabou()) break;
+      return falha("caractere invalido");
+    }
+    if (c=='#')
+    {
+      L.pularLinha();
+      continue;
+    }
+
+    if (!L.lerNome(nome, DELIM)) return falha("esperado INPUT, OUTPUT ou um nome de sinal");
+    const int linha = L.getLinha(), coluna = L.getColuna();
+
+    // Declaracao de entrada ou de saida
+    std::string chave = maiusculas(nome);
+    if ((chave=="INPUT" || chave=="OUTPUT") && L.espiar()=='(')
+    {
+      L.lerCaractere('(');
+      if (!L.lerNome(nome, DELIM)) return falha("esperado um nome de sinal");
+      int s = M.sinal(nome, L.getLinha(), L.getColuna());
+      if (chave=="INPUT")
+      {
+        if (M.definido(s)) return falha("sinal " + nome + " definido mais de uma vez");
+        M.entrada(s);
+      }
+      else M.saida(s);
+      if (!L.lerCaractere(')')) return falha("esperado )");
+      continue;
+    }
+
+    // Definicao de porta: nome = TIPO(entrada, entrada, ...)
+    int s = M.sinal(nome, linha, coluna);
+    if (!L.lerCaractere('=')) return falha("esperado =");
+    if (M.definido(s)) return falhaEm(linha, coluna, "sinal " + nome + " definido mais de uma vez");
+    if (!L.lerNome(palavra, DELIM)) return falha("esperado o tipo da porta");
+    const int linhaTipo = L.getLinha(), colunaTipo = L.getColuna();
+    std::string tp = maiusculas(palavra);
+    if (!L.lerCaractere('(')) return falha("esperado (");
+    in.clear();
+    if (L.espiar()!=')')
+    {
+      do
+      {
+        if (!L.lerNome(nome, DELIM)) return falha("esperado um nome de sinal");
+        in.push_back(M.sinal(nome, L.getLinha(), L.getColuna()));
+      } while (L.lerCaractere(','));
+    }
+    if (!L.lerCaractere(')')) return falha("esperado , ou )");
+
+    const int N = int(in.size());
+    TipoPorta T;
+    if (tp=="AND") T = TipoPorta::AN;
+    else if (tp=="NAND") T = TipoPorta::NA;
+    else if (tp=="OR") T = TipoPorta::OR;
+    else if (tp=="NOR") T = TipoPorta::NO;
+    else if (tp=="XOR") T = TipoPorta::XO;
+    else if (tp=="XNOR") T = TipoPorta::NX;
+    else if (tp=="NOT" || tp=="BUFF" || tp=="BUF" || tp=="DFF")
+    {
+      if (N!=1) return falhaEm(linhaTipo, colunaTipo, tp + " deve ter uma entrada");
+      if (tp=="DFF")
+      {
+        M.flipflop(s, in[0]);
+        continue;
+      }
+      T = (tp=="NOT" ? TipoPorta::NT : TipoPorta::AN);
+    }
+    else return falhaEm(linhaTipo, colunaTipo, "tipo de porta desconhecido: " + palavra);
+    if (N==0) return falhaEm(linhaTipo, colunaTipo, "porta sem entradas");
+    M.porta(s, T, in.data(), N);
+  }
+
+  return M.montar(C, nomes, erro);
+}
+
+/// ***********************
+/// FORMATO BLIF
+/// ***********************
+
+// Uma cobertura (.names) do formato BLIF sendo lida: o sinal de saida, os sinais das
+// entradas e os cubos (linhas) jah lidos, cada um como uma lista de literais.
+// Soh a cobertura atual fica na memoria: ela eh convertida em portas quando acaba.
+struct CoberturaBlif
+{
+  // O sinal de saida (-1 se nao houver cobertura sendo lida) e os sinais das entradas
+  int saida = -1;
+  std::vector<int> entradas;
+  // Os literais de cada cubo, em formato CSR: o literal eh o indice da entrada em
+  // "entradas" (positivo) ou -(indice+1) (negado)
+  std::vector<int> iniCubo;
+  std::vector<int> literais;
+  // O valor de saida das linhas (1 = conjunto ON, 0 = conjunto OFF, -1 = sem linhas)
+  int valor = -1;
+  // Se algum cubo nao tem literais (vale 1 para qualquer entrada)
+  bool tautologia = false;
+
+  // Comeca uma nova cobertura
+  void iniciar(int s)
+  {
+    saida = s;
+    entradas.clear();
+    iniCubo.assign(1, 0);
+    literais.clear();
+    valor = -1;
+    tautologia = false;
+  }
+
+  // Converte a cobertura em portas: a saida eh o OR (conjunto ON) ou o NOR
+  // (conjunto OFF) dos cubos, e cada cubo eh o AND dos seus literais.
+  // Os casos de um soh cubo ou de cubos de um soh literal viram uma porta soh, e
+  // os literais negados usam portas NT compartilhadas (exceto quando todos os
+  // literais sao negados, caso em que o AND/OR vira NOR/NAND das entradas).
+  void converter(MontadorNetlist& M)
+  {
+    const int K = int(iniCubo.size())-1;
+    // Sem linhas, a saida eh sempre 0; com um cubo sem literais, eh sempre o valor
+    if (K==0 || tautologia)
+    {
+      M.constante(saida, K>0 && valor==1);
+      saida = -1;
+      return;
+    }
+    const bool on = (valor==1);
+    std::vector<int> in;
+
+    // Sinal do literal l
+    auto sinalLiteral = [&](int l)
+    {
+      return (l>=0 ? entradas[l] : M.negado(entradas[-l-1]));
+    };
+    // Se todos os literais dos cubos [k0, k1) sao negados, coloca os sinais (sem
+    // negacao) em in e retorna true
+    auto todosNegados = [&](int k0, int k1)
+    {
+      in.clear();
+      for (int k=iniCubo[k0]; k<iniCubo[k1]; ++k)
+      {
+        if (literais[k]>=0) return false;
+        in.push_back(entradas[-literais[k]-1]);
+      }
+      return true;
+    };
+
+    if (K==1)
+    {
+      // Um cubo: AND dos literais (negado no conjunto OFF)
+      if (todosNegados(0, 1))
+      {
+        // AND de entradas negadas = NOR das entradas
+        if (in.size()==1) M.porta(saida, on ? TipoPorta::NT : TipoPorta::AN, in.data(), 1);
+        else M.porta(saida, on ? TipoPorta::NO : TipoPorta::OR, in.data(), int(in.size()));
+      }
+      else
+      {
+        in.clear();
+        for (int k=iniCubo[0]; k<iniCubo[1]; ++k) in.push_back(sinalLiteral(literais[k]));
+        M.porta(saida, on ? TipoPorta::AN : TipoPorta::NA, in.data(), int(in.size()));
+      }
+      saida = -1;
+      return;
+    }
+
+    // Varios cubos: OR dos cubos (negado no conjunto OFF)
+    bool umLiteral = true;
+    for (int c=0; c<K && umLiteral; ++c) umLiteral = (iniCubo[c+1]-iniCubo[c]==1);
+    if (umLiteral && todosNegados(0, K))
+    {
+      // OR de entradas negadas = NAND das entradas
+      M.porta(saida, on ? TipoPorta::NA : TipoPorta::AN, in.data(), int(in.size()));
+      saida = -1;
+      return;
+    }
+    std::vector<int> termos(K);
+    for (int c=0; c<K; ++c)
+    {
+      if (iniCubo[c+1]-iniCubo[c]==1)
+      {
+        termos[c] = sinalLiteral(literais[iniCubo[c]]);
+        continue;
+      }
+      in.clear();
+      for (int k=iniCubo[c]; k<iniCubo[c+1]; ++k) in.push_back(sinalLiteral(literais[k]));
+      termos[c] = M.novoSinal(0, 0);
+      M.porta(termos[c], TipoPorta::AN, in.data(), int(in.size()));
+    }
+    M.porta(saida, on ? TipoPorta::OR : TipoPorta::NO, termos.data(), K);
+    saida = -1;
+  }
+};
+
+// Importa um circuito no formato BLIF
+bool importarBlif(const std::string& arq, Circuito& C, NomesCircuito* nomes, ErroLeitura* erro)
+{
+  ArquivoMapeado A;
+  if (!A.abrir(arq))
+  {
+    if (erro!=nullptr) *erro = ErroLeitura{0, 0, "nao foi possivel abrir o arquivo " + arq};
+    return false;
+  }
+  LeitorTexto L(A.getDados(), A.getTamanho());
+  // Registra um erro na posicao (linha, coluna) e retorna false
+  auto falhaEm = [erro](int linha, int coluna, const std::string& msg)
+  {
+    if (erro!=nullptr) *erro = ErroLeitura{linha, coluna, msg};
+    return false;
+  };
+  // Registra um erro na posicao do ultimo elemento lido e retorna false
+  auto falha = [&L, &falhaEm](const std::string& msg)
+  {
+    return falhaEm(L.getLinha(), L.getColuna(), msg);
+  };
+
+  // Os nomes soh terminam em espacos em branco ou no inicio de um comentario
+  const char* DELIM = "#";
+  MontadorNetlist M;
+  CoberturaBlif cob;
+  std::string palavra, nome;
+  std::vector<std::string> resto;
+
+  while (true)
+  {
+    char c = L.espiar();
+    if (c=='\0')
+    {
+      // Fim do texto ou um caractere nulo no meio do arquivo
+      if (L.acabou()) break;
+      return falha("caractere invalido");
+    }
+    if (c=='#')
+    {
+      L.pularLinha();
+      continue;
+    }
+
+    // Linha de uma cobertura: plano de entrada (0, 1 ou - para cada entrada) e valor
+    if (c!='.')
+    {
+      if (cob.saida<0) return falha("esperado um comando (.names, .inputs, ...)");
+      const int NE = int(cob.entradas.size());
+      if (NE>0)
+      {
+        if (!L.lerNome(palavra, DELIM)) return falha("nome invalido");
+        if (int(palavra.size())!=NE)
+          return falha("esperados " + std::to_string(NE) + " valores de entrada");
+        for (int i=0; i<NE; ++i)
+        {
+          if (palavra[i]=='1') cob.literais.push_back(i);
+          else if (palavra[i]=='0') cob.literais.push_back(-i-1);
+          else if (palavra[i]!='-') return falha("valor de entrada invalido: " + palavra);
+        }
+        if (L.fimDeLinha('#')) return falha("esperado o valor de saida");
+      }
+      if (!L.lerNome(palavra, DELIM)) return falha("nome invalido");
+      if (palavra!="0" && palavra!="1") return falha("valor de saida invalido: " + palavra);
+      int v = palavra[0]-'0';
+      if (cob.valor>=0 && v!=cob.valor)
+        return falha("linhas com valores de saida diferentes na mesma cobertura");
+      cob.valor = v;
+      if (cob.literais.size()==size_t(cob.iniCubo.back())) cob.tautologia = true;
+      cob.iniCubo.push_back(int(cob.literais.size()));
+      if (!L.fimDeLinha('#')) return falha("esperado o fim da linha");
+      L.pularLinha();
+      continue;
+    }
+
+    // Um comando termina a cobertura anterior
+    if (cob.saida>=0) cob.converter(M);
+    if (!L.lerNome(palavra, DELIM)) return falha("nome invalido");
+    const int linha = L.getLinha(), coluna = L.getColuna();
+    // Le os nomes ateh o fim da linha (incluindo as continuacoes)
+    resto.clear();
+    while (!L.fimDeLinha('#'))
+    {
+      if (!L.lerNome(nome, DELIM)) return falha("nome invalido");
+      resto.push_back(nome);
+    }
+    L.pularLinha();
+
+    if (palavra==".inputs" || palavra==".outputs")
+    {
+      for (const std::string& n : resto)
+      {
+        int s = M.sinal(n, linha, coluna);
+        if (palavra==".outputs") M.saida(s);
+        else
+        {
+          if (M.definido(s)) return falhaEm(linha, coluna, "sinal " + n + " definido mais de uma vez");
+          M.entrada(s);
+        }
+      }
+    }
+    else if (palavra==".names")
+    {
+      if (resto.empty()) return falhaEm(linha, coluna, ".names sem sinal de saida");
+      int s = M.sinal(resto.back(), linha, coluna);
+      if (M.definido(s))
+        return falhaEm(linha, coluna, "sinal " + resto.back() + " definido mais de uma vez");
+      cob.iniciar(s);
+      for (size_t i=0; i+1<resto.size(); ++i) cob.entradas.push_back(M.sinal(resto[i], linha, coluna));
+    }
+    else if (palavra==".latch")
+    {
+      // .latch entrada saida [tipo controle] [valor inicial]
+      if (resto.size()<2) return falhaEm(linha, coluna, ".latch sem entrada ou saida");
+      int d = M.sinal(resto[0], linha, coluna);
+      int q = M.sinal(resto[1], linha, coluna);
+      if (M.definido(q))
+        return falhaEm(linha, coluna, "sinal " + resto[1] + " definido mais de uma vez");
+      M.flipflop(q, d);
+    }
+    else if (palavra==".end" || palavra==".exdc")
+    {
+      // Soh o primeiro modelo eh lido (e sem o circuito de don't cares externo)
+      break;
+    }
+    else if (palavra==".subckt" || palavra==".gate" || palavra==".mlatch" ||
+             palavra==".search" || palavra==".start_kiss")
+    {
+      return falhaEm(linha, coluna, "comando nao suportado: " + palavra);
+    }
+    // Os demais comandos (.model, .clock e as informacoes de atraso) sao ignorados
+  }
+  if (cob.saida>=0) cob.converter(M);
+
+  return M.montar(C, nomes, erro);
+}
+
+/// ***********************
+/// FORMATO VERILOG ESTRUTURAL
+/// ***********************
+
+// Separa um texto Verilog em elementos: identificadores (inclusive os identificadores
+// com escape, sem a barra invertida inicial), numeros e simbolos de um caractere.
+// Os comentarios (// e /* */), os atributos ((* *)) e as diretivas do compilador
+// (`timescale, ...) sao pulados.
+class LexicoVerilog
+{
+private:
+  LeitorTexto& L;
+  // Os caracteres que terminam um identificador ou numero
+  static constexpr const char* DELIM = "()[]{},;:=~'\"/#@*+-!&|^?<>.`\\";
+
+public:
+  explicit LexicoVerilog(LeitorTexto& leitor): L(leitor) {}
+
+  // Pula os espacos e os comentarios e retorna o proximo caractere ('\0' no fim),
+  // sem consumi-lo. A posicao do proximo elemento fica em L.getLinha/getColuna.
+  char espiar()
+  {
+    while (true)
+    {
+      char c = L.espiar();
+      if (c=='/' && L.lerSequencia("//")) L.pularLinha();
+      else if (c=='/' && L.lerSequencia("/*")) L.pularAte("*/");
+      else if (c=='(' && L.lerSequencia("(*")) L.pularAte("*)");
+      else if (c=='`') L.pularLinha();
+      else return c;
+    }
+  }
+
+  // Le um identificador ou numero em s.
+  // Retorna false se o proximo elemento for um simbolo ou o fim do texto.
+  bool lerNome(std::string& s)
+  {
+    char c = espiar();
+    if (c=='\\')
+    {
+      // Identificador com escape: termina no primeiro espaco em branco
+      L.lerPalavra(s);
+      s.erase(0, 1);
+      return !s.empty();
+    }
+    return L.lerNome(s, DELIM);
+  }
+
+  // Le o simbolo c.
+  // Retorna false (sem consumir nada) se o proximo elemento for diferente.
+  bool lerSimbolo(char c)
+  {
+    return espiar()==c && L.lerCaractere(c);
+  }
+};
+
+// Converte o nome de uma primitiva Verilog no tipo de porta. Retorna false se o nome nao
+// for de uma primitiva (em buf, T recebe AN, que vira buffer com uma entrada soh).
+static bool primitivaVerilog(const std::string& nome, TipoPorta& T)
+{
+  if (nome=="and") T = TipoPorta::AN;
+  else if (nome=="nand") T = TipoPorta::NA;
+  else if (nome=="or") T = TipoPorta::OR;
+  else if (nome=="nor") T = TipoPorta::NO;
+  else if (nome=="xor") T = TipoPorta::XO;
+  else if (nome=="xnor") T = TipoPorta::NX;
+  else if (nome=="not") T = TipoPorta::NT;
+  else if (nome=="buf") T = TipoPorta::AN;
+  else return false;
+  return true;
+}
+
+// Importa um circuito em Verilog estrutural
+bool importarVerilog(const std::string& arq, Circuito& C, NomesCircuito* nomes, ErroLeitura* erro)
+{
+  ArquivoMapeado A;
+  if (!A.abrir(arq))
+  {
+    if (erro!=nullptr) *erro = ErroLeitura{0, 0, "nao foi possivel abrir o arquivo " + arq};
+    return false;
+  }
+  LeitorTexto L(A.getDados(), A.getTamanho());
+  LexicoVerilog V(L);
+  // Registra um erro na posicao (linha, coluna) e retorna false
+  auto falhaEm = [erro](int linha, int coluna, const std::string& msg)
+  {
+    if (erro!=nullptr) *erro = ErroLeitura{linha, coluna, msg};
+    return false;
+  };
+  // Registra um erro na posicao do proximo elemento e retorna false
+  auto falha = [&V, &L, &falhaEm](const std::string& msg)
+  {
+    V.espiar();
+    return falhaEm(L.getLinha(), L.getColuna(), msg);
+  };
+
+  MontadorNetlist M;
+  // Os vetores declarados, para detectar o uso de um vetor inteiro como um sinal
+  std::unordered_map<std::string, std::pair<int,int>> vetores;
+  // Os sinais das constantes 0 e 1 usadas como terminais (-1 se ainda nao usadas)
+  int constantes[2] = {-1, -1};
+  std::string palavra, nome;
+  std::vector<int> term;
+
+  // Le uma faixa [msb:lsb]
+  auto lerFaixa = [&](int& msb, int& lsb)
+  {
+    if (!V.lerSimbolo('[') || !L.lerInteiro(msb) || !V.lerSimbolo(':') ||
+        !L.lerInteiro(lsb) || !V.lerSimbolo(']'))
+      return falha("faixa [msb:lsb] invalida");
+    return true;
+  };
+  // Le o tipo opcional (wire, reg, signed), a faixa opcional e o primeiro nome de uma
+  // declaracao. vetor indica se houve faixa.
+  auto lerTipo = [&](std::string& n, bool& vetor, int& msb, int& lsb)
+  {
+    vetor = false;
+    while (true)
+    {
+      if (V.espiar()=='[')
+      {
+        if (!lerFaixa(msb, lsb)) return false;
+        vetor = true;
+      }
+      if (!V.lerNome(n)) return falha("esperado um nome de sinal");
+      if (vetor || (n!="wire" && n!="reg" && n!="signed")) return true;
+    }
+  };
+  // Declara o sinal (ou todos os bits do vetor) n como entrada, saida ou fio (dir).
+  // Os fios soh passam a existir quando sao usados.
+  auto declarar = [&](const std::string& dir, const std::string& n, bool vetor, int msb, int lsb)
+  {
+    const int linha = L.getLinha(), coluna = L.getColuna();
+    const int passo = (msb>=lsb ? -1 : 1);
+    if (vetor) vetores[n] = {msb, lsb};
+    if (dir=="wire") return true;
+    for (int k=msb; ; k+=passo)
+    {
+      const std::string bit = (vetor ? n + "[" + std::to_string(k) + "]" : n);
+      int s = M.sinal(bit, linha, coluna);
+      if (dir=="input")
+      {
+        if (M.definido(s)) return falhaEm(linha, coluna, "sinal " + bit + " definido mais de uma vez");
+        M.entrada(s);
+      }
+      else if (dir=="output") M.saida(s);
+      if (!vetor || k==lsb) break;
+    }
+    return true;
+  };
+  // Le uma referencia a um sinal: nome, nome[bit] ou uma constante de um bit (1'b0,
+  // 1'b1). Em s fica o sinal (-1 se for uma constante) e em v, o valor da constante
+  // (-1 se nao for constante).
+  auto lerSinal = [&](int& s, int& v)
+  {
+    const char c = V.espiar();
+    const int linha = L.getLinha(), coluna = L.getColuna();
+    if (!V.lerNome(nome)) return falha("esperado um sinal");
+    if (c>='0' && c<='9')
+    {
+      if (nome!="1" || !V.lerSimbolo('\'') || !V.lerNome(palavra) ||
+          (palavra!="b0" && palavra!="b1" && palavra!="B0" && palavra!="B1"))
+        return falhaEm(linha, coluna, "constante invalida (esperado 1'b0 ou 1'b1)");
+      v = palavra[1]-'0';
+      s = -1;
+      return true;
+    }
+    v = -1;
+    if (V.lerSimbolo('['))
+    {
+      int k;
+      if (!L.lerInteiro(k) || !V.lerSimbolo(']')) return falha("indice invalido");
+      nome += "[" + std::to_string(k) + "]";
+    }
+    else if (vetores.count(nome)>0) return falhaEm(linha, coluna, "vetor " + nome + " usado sem indice");
+    s = M.sinal(nome, linha, coluna);
+    return true;
+  };
+  // Retorna o sinal da constante v usada como terminal de uma porta
+  auto sinalConstante = [&](int v)
+  {
+    if (constantes[v]<0)
+    {
+      constantes[v] = M.novoSinal(0, 0);
+      M.constante(constantes[v], v==1);
+    }
+    return constantes[v];
+  };
+  // Le um sinal que vai ser definido (nao pode ser uma constante nem jah definido)
+  auto lerDestino = [&](int& s)
+  {
+    V.espiar();
+    const int linha = L.getLinha(), coluna = L.getColuna();
+    int v;
+    if (!lerSinal(s, v)) return false;
+    if (v>=0) return falhaEm(linha, coluna, "uma constante nao pode ser definida");
+    if (M.definido(s)) return falhaEm(linha, coluna, "sinal " + M.getNome(s) + " definido mais de uma vez");
+    return true;
+  };
+
+  // Cabecalho: module nome (portas);
+  if (!V.lerNome(palavra) || palavra!="module") return falha("esperado module");
+  if (!V.lerNome(nome)) return falha("esperado o nome do modulo");
+  if (V.espiar()=='#') return falha("modulos com parametros nao sao suportados");
+  if (V.lerSimbolo('(') && !V.lerSimbolo(')'))
+  {
+    // Lista de portas, soh com os nomes ou com as declaracoes (estilo ANSI)
+    std::string dir;
+    bool vetor = false;
+    int msb = 0, lsb = 0;
+    do
+    {
+      if (!V.lerNome(nome)) return falha("esperado um nome de porta");
+      if (nome=="input" || nome=="output")
+      {
+        dir = nome;
+        if (!lerTipo(nome, vetor, msb, lsb)) return false;
+      }
+      else if (nome=="inout") return falha("portas inout nao sao suportadas");
+      if (!dir.empty() && !declarar(dir, nome, vetor, msb, lsb)) return false;
+    } while (V.lerSimbolo(','));
+    if (!V.lerSimbolo(')')) return falha("esperado , ou )");
+  }
+  if (!V.lerSimbolo(';')) return falha("esperado ;");
+
+  // Corpo: declaracoes, atribuicoes e portas primitivas, ateh endmodule
+  while (true)
+  {
+    if (V.espiar()=='\0') return falha("esperado endmodule");
+    if (!V.lerNome(palavra)) return falha("esperada uma declaracao, assign ou porta");
+    const int linha = L.getLinha(), coluna = L.getColuna();
+    TipoPorta T;
+
+    if (palavra=="endmodule") break;
+
+    if (palavra=="input" || palavra=="output" || palavra=="wire")
+    {
+      // Declaracao: input [msb:lsb] a, b, ...;
+      bool vetor;
+      int msb = 0, lsb = 0;
+      if (!lerTipo(nome, vetor, msb, lsb)) return false;
+      while (true)
+      {
+        if (!declarar(palavra, nome, vetor, msb, lsb)) return false;
+        if (!V.lerSimbolo(',')) break;
+        if (!V.lerNome(nome)) return falha("esperado um nome de sinal");
+      }
+    }
+    else if (palavra=="assign")
+    {
+      // Atribuicao de um sinal, negado ou nao, ou de uma constante: assign a = ~b;
+      do
+      {
+        int s, in, v;
+        if (!lerDestino(s)) return false;
+        if (!V.lerSimbolo('=')) return falha("esperado =");
+        bool negado = V.lerSimbolo('~');
+        if (!lerSinal(in, v)) return false;
+        if (V.espiar()!=',' && V.espiar()!=';') return falha("expressao nao suportada em assign");
+        if (v>=0) M.constante(s, (v==1)!=negado);
+        else M.porta(s, negado ? TipoPorta::NT : TipoPorta::AN, &in, 1);
+      } while (V.lerSimbolo(','));
+    }
+    else if (primitivaVerilog(palavra, T))
+    {
+      // Porta primitiva: tipo [#atraso] [instancia] (saida, entrada, ...), ...;
+      // (em not e buf: (saida, ..., saida, entrada))
+      if (V.lerSimbolo('#'))
+      {
+        // O atraso eh ignorado
+        if (V.lerSimbolo('('))
+        {
+          while (!V.lerSimbolo(')'))
+          {
+            if (V.espiar()=='\0') return falha("esperado )");
+            if (!V.lerNome(nome)) L.lerCaractere(V.espiar());
+          }
+        }
+        else V.lerNome(nome);
+      }
+      const bool umaEntrada = (palavra=="not" || palavra=="buf");
+      do
+      {
+        if (V.espiar()!='(')
+        {
+          if (!V.lerNome(nome)) return falha("esperado o nome da instancia ou (");
+          if (V.espiar()=='[') return falha("vetores de instancias nao sao suportados");
+        }
+        if (!V.lerSimbolo('(')) return falha("esperado (");
+        term.clear();
+        int s, v;
+        // As saidas
+        if (!lerDestino(s)) return false;
+        term.push_back(s);
+        while (V.lerSimbolo(','))
+        {
+          if (!lerSinal(s, v)) return false;
+          term.push_back(v>=0 ? sinalConstante(v) : s);
+        }
+        if (!V.lerSimbolo(')')) return falha("esperado , ou )");
+        const int N = int(term.size());
+        if (N<2) return falhaEm(linha, coluna, "porta " + palavra + " sem entradas");
+        if (umaEntrada)
+        {
+          for (int i=0; i<N-1; ++i)
+          {
+            if (i>0 && M.definido(term[i]))
+              return falhaEm(linha, coluna, "sinal " + M.getNome(term[i]) + " definido mais de uma vez");
+            M.porta(term[i], T, &term[N-1], 1);
+          }
+        }
+        else
+        {
+          M.porta(term[0], T, term.data()+1, N-1);
+        }
+      } while (V.lerSimbolo(','));
+    }
+    else if (palavra=="inout") return falhaEm(linha, coluna, "portas inout nao sao suportadas");
+    else return falhaEm(linha, coluna, "instancia de modulo nao suportada: " + palavra);
+
+    if (!V.lerSimbolo(';')) return falha("esperado ;");
+  }
+
+  return M.montar(C, nomes, erro);
+}
+
+// Retorna a extensao do nome do arquivo, em maiusculas (vazia se nao houver)
+static std::string extensao(const std::string& arq)
+{
+  size_t ponto = arq.rfind('.');
+  return (ponto==std::string::npos ? "" : maiusculas(arq.substr(ponto+1)));
+}
+
+// Retorna true se a extensao do nome do arquivo eh de um dos formatos de netlist
+bool formatoNetlist(const std::string& arq)
+{
+  std::string ext = extensao(arq);
+  return ext=="BENCH" || ext=="BLIF" || ext=="V";
+}
+
+// Importa um circuito, escolhendo o formato pela extensao do nome do arquivo
+bool importarNetlist(const std::string& arq, Circuito& C, NomesCircuito* nomes, ErroLeitura* erro)
+{
+  std::string ext = extensao(arq);
+  if (ext=="BENCH") return importarBench(arq, C, nomes, erro);
+  if (ext=="BLIF") return importarBlif(arq, C, nomes, erro);
+  if (ext=="V") return importarVerilog(arq, C, nomes, erro);
+  if (erro!=nullptr) *erro = ErroLeitura{0, 0, "formato de arquivo desconhecido: " + arq};
+  return false;
+}
@@ -0,0 +1,136 @@
+#ifndef _IMPORTAR_H_
+#define _IMPORTAR_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "circuito.h"
+#include "leitortexto.h"
+
+/// ###########################################################################
+/// IMPORTACAO DE NETLISTS EM FORMATOS PADRAO
+///
+/// Os importadores leem circuitos descritos com nomes simbolicos de sinais e
+/// montam um Circuito, numerando as entradas (-1, -2, ...) na ordem em que sao
+/// declaradas e as portas (1, 2, ...) na ordem em que sao definidas no arquivo.
+/// Os nomes originais ficam em uma tabela de nomes (NomesCircuito), para
+/// relatorios e depuracao.
+/// Todos os importadores mapeiam o arquivo na memoria e o leem em uma unica
+/// passada; se encontrarem um erro, nao alteram o circuito, retornam false e,
+/// se erro!=nullptr, preenchem *erro com a linha, a coluna e o motivo.
+/// ###########################################################################
+
+// O nome da entrada extra das constantes (ver NomesCircuito::entradaConstante), que
+// nao pode ser nome de sinal em nenhum dos formatos (tem espacos)
+constexpr const char* NOME_CONSTANTE = "<constante 1>";
+
+// A tabela de nomes de um circuito importado
+struct NomesCircuito
+{
+  // Nome de cada entrada do circuito: entradas[i] eh o nome da entrada de id -(i+1)
+  std::vector<std::string> entradas;
+  // Nome de cada saida do circuito: saidas[j] eh o nome do sinal da saida de id j+1
+  std::vector<std::string> saidas;
+  // Nome de cada porta: portas[i] eh o nome do sinal de saida da porta de id i+1
+  // (vazio para as portas criadas pelo importador, que nao existem no arquivo)
+  std::vector<std::string> portas;
+  // A id de origem (entrada ou porta) de cada sinal com nome
+  std::unordered_map<std::string, int> ids;
+  // Numero de flip-flops (elementos sequenciais) do arquivo, que foram cortados:
+  // as ultimas Nflipflops entradas sao as saidas dos flip-flops e as ultimas
+  // Nflipflops saidas sao as entradas dos flip-flops, na mesma ordem
+  int Nflipflops = 0;
+  // A id da entrada extra que fornece as constantes do arquivo (1'b0, 1'b1, coberturas
+  // BLIF sem entradas), ou 0 se nao houver constantes. Essa entrada, de nome
+  // NOME_CONSTANTE, fica logo depois das entradas do arquivo (antes das saidas dos
+  // flip-flops) e deve ser mantida TRUE: o circuito soh equivale ao arquivo nas
+  // combinacoes de entradas em que ela eh TRUE. Fixando-a em TRUE em simplificar
+  // (otimizar.h), as constantes sao propagadas e as portas que elas tornam constantes
+  // sao eliminadas; as saidas constantes passam a vir diretamente dessa entrada.
+  int entradaConstante = 0;
+
+  // Retorna a id de origem do sinal de nome "nome", ou 0 se nao houver sinal com esse nome
+  int idOrig(const std::string& nome) const
+  {
+    auto achou = ids.find(nome);
+    return (achou==ids.end() ? 0 : achou->second);
+  }
+
+  // Limpa a tabela
+  void clear()
+  {
+    entradas.clear();
+    saidas.clear();
+    portas.clear();
+    ids.clear();
+    Nflipflops = 0;
+    entradaConstante = 0;
+  }
+};
+
+// Importa um circuito no formato .bench (ISCAS-85 e ISCAS-89):
+//   # comentario
+//   INPUT(G1)
+//   OUTPUT(G17)
+//   G10 = NAND(G1, G3)
+// As portas AND, NAND, OR, NOR, XOR, XNOR e NOT viram as portas do mesmo tipo, com
+// qualquer numero de entradas. Um BUFF (ou BUF), ou uma porta de uma entrada
+// so, vira uma porta AN com a mesma origem nas duas entradas (ou NT, se a porta for
+// negada), jah que nao existe porta buffer. Os flip-flops (DFF) dos circuitos
+// sequenciais ISCAS-89 sao cortados (como em um circuito com scan completo):
+// a saida de cada flip-flop vira uma nova entrada do circuito e a sua entrada vira uma
+// nova saida (ver NomesCircuito::Nflipflops). Os nomes das portas nao diferenciam
+// maiusculas e minusculas.
+bool importarBench(const std::string& arq, Circuito& C, NomesCircuito* nomes=nullptr,
+                   ErroLeitura* erro=nullptr);
+
+// Importa um circuito no formato BLIF (Berkeley Logic Interchange Format), o formato
+// de saida das ferramentas de sintese logica (SIS, ABC, Yosys):
+//   .model nome
+//   .inputs a b c
+//   .outputs y
+//   .names a b t       # cobertura: t = a.b + ~a.~b
+//   11 1
+//   00 1
+//   .latch t q re clk 0
+//   .end
+// Cada cobertura (.names) vira portas: a saida eh o OR (ou o NOR, se as linhas forem
+// do conjunto OFF) dos cubos e cada cubo eh o AND dos seus literais, com portas NT
+// compartilhadas para os literais negados e sem portas intermediarias nos casos de um
+// cubo soh ou de cubos com um literal soh. As portas criadas para os cubos e para as
+// negacoes nao tem nome. As constantes (coberturas sem entradas) vem de uma entrada
+// extra, que deve ser mantida TRUE (ver NomesCircuito::entradaConstante).
+// Os latches sao cortados como os flip-flops do formato .bench. Soh o primeiro modelo
+// eh lido; hierarquia (.subckt) e circuitos mapeados em bibliotecas (.gate) nao sao
+// suportados. Os comandos de atraso e de relogio sao ignorados.
+bool importarBlif(const std::string& arq, Circuito& C, NomesCircuito* nomes=nullptr,
+                  ErroLeitura* erro=nullptr);
+
+// Importa um circuito em Verilog estrutural (netlist no nivel de portas), como o
+// gerado pelas ferramentas de sintese:
+//   module top(a, b, y);      // ou module top(input a, input b, output y);
+//     input a, b;
+//     output y;
+//     wire w;
+//     nand g1(w, a, b);        // saida primeiro; o nome da instancia eh opcional
+//     not (y, w);
+//   endmodule
+// Sao aceitas as primitivas and, nand, or, nor, xor, xnor, not e buf (not e buf
+// podem ter varias saidas; a entrada eh o ultimo terminal), as atribuicoes simples
+// (assign a = b; assign a = ~b; assign a = 1'b0;), vetores ([msb:lsb]) usados bit a
+// bit, cujos bits recebem os nomes "a[3]", "a[2]", ..., e as constantes 1'b0 e 1'b1
+// (ver importarBlif). Os atrasos, os atributos e as diretivas (`timescale) sao
+// ignorados. Soh o primeiro modulo eh lido e ele nao pode instanciar outros modulos
+// nem conter expressoes.
+bool importarVerilog(const std::string& arq, Circuito& C, NomesCircuito* nomes=nullptr,
+                     ErroLeitura* erro=nullptr);
+
+// Importa um circuito em qualquer um dos formatos acima, escolhido pela extensao do
+// nome do arquivo: .bench, .blif ou .v (sem diferenciar maiusculas e minusculas)
+bool importarNetlist(const std::string& arq, Circuito& C, NomesCircuito* nomes=nullptr,
+                     ErroLeitura* erro=nullptr);
+
+// Retorna true se a extensao do nome do arquivo eh de um dos formatos acima
+bool formatoNetlist(const std::string& arq);
+
+#endif // _IMPORTAR_H_
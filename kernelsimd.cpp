@@ -0,0 +1,188 @@
+#include "kernelsimd.h"
+
+// Os kernels AVX2 e AVX-512 soh sao compilados com GCC/Clang em processadores x86.
+// Cada funcao eh compilada com o atributo "target", de modo que o restante do programa
+// nao precisa de opcoes especiais de compilacao e roda em qualquer CPU.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELSIMD_X86
+#include <immintrin.h>
+#endif
+
+// Retorna true se o tipo de porta eh uma porta negada (NT, NA, NO, NX).
+// Uma porta negada eh avaliada como a porta direta, trocando-se os trilhos no final.
+static inline bool portaNegada(TipoPorta tipo)
+{
+  return (tipo==TipoPorta::NT || tipo==TipoPorta::NA ||
+          tipo==TipoPorta::NO || tipo==TipoPorta::NX);
+}
+
+/// ***********************
+/// Kernel ESCALAR
+/// ***********************
+
+// A logica generica das portas (avaliarPorta) instanciada para o dominio bool3S_bloco:
+// os operadores de bool3S_bloco processam uma palavra de 64 bits por vez
+static void kernelEscalar(TipoPorta tipo, const int* orig, int n,
+                          const bool3S_bloco* V, bool3S_bloco& dest)
+{
+  dest = avaliarPorta(tipo, V, orig, n);
+}
+
+#ifdef KERNELSIMD_X86
+
+/// ***********************
+/// Kernel AVX2 (cada trilho do bloco ocupa 2 registradores de 256 bits)
+/// ***********************
+
+__attribute__((target("avx2")))
+static void kernelAVX2(TipoPorta tipo, const int* orig, int n,
+                       const bool3S_bloco* V, bool3S_bloco& dest)
+{
+  constexpr int NREG = PALAVRAS_BLOCO/4;
+  __m256i t[NREG], f[NREG];
+  int k, h;
+
+  for (h=0; h<NREG; ++h)
+  {
+    t[h] = _mm256_load_si256(reinterpret_cast<const __m256i*>(V[orig[0]].t)+h);
+    f[h] = _mm256_load_si256(reinterpret_cast<const __m256i*>(V[orig[0]].f)+h);
+  }
+
+  for (k=1; k<n; ++k)
+  {
+    const __m256i* xt = reinterpret_cast<const __m256i*>(V[orig[k]].t);
+    const __m256i* xf = reinterpret_cast<const __m256i*>(V[orig[k]].f);
+    for (h=0; h<NREG; ++h)
+    {
+      __m256i at = _mm256_load_si256(xt+h);
+      __m256i af = _mm256_load_si256(xf+h);
+      switch (tipo)
+      {
+      case TipoPorta::AN:
+      case TipoPorta::NA:
+        t[h] = _mm256_and_si256(t[h], at);
+        f[h] = _mm256_or_si256(f[h], af);
+        break;
+      case TipoPorta::OR:
+      case TipoPorta::NO:
+        t[h] = _mm256_or_si256(t[h], at);
+        f[h] = _mm256_and_si256(f[h], af);
+        break;
+      case TipoPorta::XO:
+      case TipoPorta::NX:
+      {
+        __m256i novo_t = _mm256_or_si256(_mm256_and_si256(t[h], af), _mm256_and_si256(f[h], at));
+        f[h] = _mm256_or_si256(_mm256_and_si256(t[h], at), _mm256_and_si256(f[h], af));
+        t[h] = novo_t;
+        break;
+      }
+      case TipoPorta::NT:
+        break;
+      }
+    }
+  }
+
+  bool negada = portaNegada(tipo);
+  for (h=0; h<NREG; ++h)
+  {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(dest.t)+h, negada ? f[h] : t[h]);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(dest.f)+h, negada ? t[h] : f[h]);
+  }
+}
+
+/// ***********************
+/// Kernel AVX-512 (cada trilho do bloco ocupa 1 registrador de 512 bits)
+/// ***********************
+
+__attribute__((target("avx512f")))
+static void kernelAVX512(TipoPorta tipo, const int* orig, int n,
+                         const bool3S_bloco* V, bool3S_bloco& dest)
+{
+  static_assert(PALAVRAS_BLOCO==8, "O kernel AVX-512 supoe blocos de 512 bits por trilho");
+  __m512i t = _mm512_load_si512(V[orig[0]].t);
+  __m512i f = _mm512_load_si512(V[orig[0]].f);
+
+  switch (tipo)
+  {
+  case TipoPorta::NT:
+    break;
+  case TipoPorta::AN:
+  case TipoPorta::NA:
+    for (int k=1; k<n; ++k)
+    {
+      t = _mm512_and_si512(t, _mm512_load_si512(V[orig[k]].t));
+      f = _mm512_or_si512(f, _mm512_load_si512(V[orig[k]].f));
+    }
+    break;
+  case TipoPorta::OR:
+  case TipoPorta::NO:
+    for (int k=1; k<n; ++k)
+    {
+      t = _mm512_or_si512(t, _mm512_load_si512(V[orig[k]].t));
+      f = _mm512_and_si512(f, _mm512_load_si512(V[orig[k]].f));
+    }
+    break;
+  case TipoPorta::XO:
+  case TipoPorta::NX:
+    for (int k=1; k<n; ++k)
+    {
+      __m512i at = _mm512_load_si512(V[orig[k]].t);
+      __m512i af = _mm512_load_si512(V[orig[k]].f);
+      __m512i novo_t = _mm512_or_si512(_mm512_and_si512(t, af), _mm512_and_si512(f, at));
+      f = _mm512_or_si512(_mm512_and_si512(t, at), _mm512_and_si512(f, af));
+      t = novo_t;
+    }
+    break;
+  }
+
+  bool negada = portaNegada(tipo);
+  _mm512_store_si512(dest.t, negada ? f : t);
+  _mm512_store_si512(dest.f, negada ? t : f);
+}
+
+#endif // KERNELSIMD_X86
+
+/// ***********************
+/// Escolha do kernel em tempo de execucao
+/// ***********************
+
+// Retorna o melhor conjunto de instrucoes suportado pela CPU
+NivelSIMD nivelSIMD()
+{
+#ifdef KERNELSIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return NivelSIMD::AVX512;
+  if (__builtin_cpu_supports("avx2")) return NivelSIMD::AVX2;
+#endif
+  return NivelSIMD::ESCALAR;
+}
+
+// Retorna o nome de um conjunto de instrucoes
+const char* nomeSIMD(NivelSIMD N)
+{
+  switch (N)
+  {
+  case NivelSIMD::AVX2: return "AVX2";
+  case NivelSIMD::AVX512: return "AVX512";
+  default: return "ESCALAR";
+  }
+}
+
+// Retorna o kernel de um conjunto de instrucoes, se suportado
+KernelPorta kernelPorta(NivelSIMD N)
+{
+  if (N==NivelSIMD::ESCALAR) return kernelEscalar;
+#ifdef KERNELSIMD_X86
+  NivelSIMD melhor = nivelSIMD();
+  if (N==NivelSIMD::AVX2 && melhor!=NivelSIMD::ESCALAR) return kernelAVX2;
+  if (N==NivelSIMD::AVX512 && melhor==NivelSIMD::AVX512) return kernelAVX512;
+#endif
+  return nullptr;
+}
+
+// Retorna o kernel do melhor conjunto de instrucoes suportado
+KernelPorta kernelPorta()
+{
+  static const KernelPorta melhor = kernelPorta(nivelSIMD());
+  return melhor;
+}
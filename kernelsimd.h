@@ -0,0 +1,49 @@
+#ifndef _KERNELSIMD_H_
+#define _KERNELSIMD_H_
+
+#include "bool3S64.h"
+#include "porta.h"
+
+/// ###########################################################################
+/// KERNELS VETORIAIS (SIMD) DE AVALIACAO DE PORTAS
+///
+/// Cada kernel avalia uma porta de qualquer tipo e qualquer numero de entradas
+/// para um bloco de BOOL3S_BLOCO vetores de entrada (valores bool3S_bloco).
+/// Existem tres implementacoes, com resultados identicos:
+/// - ESCALAR: C++ portavel, uma palavra de 64 bits por vez (a mesma logica generica
+///   de avaliarPorta usada pelos demais dominios de valores)
+/// - AVX2: 256 bits por instrucao
+/// - AVX512: 512 bits por instrucao
+/// A melhor implementacao suportada pela CPU eh escolhida em tempo de execucao.
+/// ###########################################################################
+
+// Os conjuntos de instrucoes para os quais existem kernels
+enum class NivelSIMD
+{
+  ESCALAR,
+  AVX2,
+  AVX512
+};
+
+// Um kernel de avaliacao de porta.
+// Avalia uma porta do tipo "tipo" cujas "n" entradas vem dos sinais orig[0] ... orig[n-1],
+// cujos valores estao em V, e armazena o resultado em dest.
+// dest pode ser um dos sinais de entrada.
+using KernelPorta = void (*)(TipoPorta tipo, const int* orig, int n,
+                             const bool3S_bloco* V, bool3S_bloco& dest);
+
+// Retorna o melhor conjunto de instrucoes suportado pela CPU em que o programa estah rodando
+NivelSIMD nivelSIMD();
+
+// Retorna o nome de um conjunto de instrucoes ("ESCALAR", "AVX2" ou "AVX512")
+const char* nomeSIMD(NivelSIMD N);
+
+// Retorna o kernel do conjunto de instrucoes N,
+// ou nullptr se a CPU (ou o compilador) nao suportar esse conjunto.
+KernelPorta kernelPorta(NivelSIMD N);
+
+// Retorna o kernel do melhor conjunto de instrucoes suportado pela CPU
+// (escolhido uma unica vez, na primeira chamada).
+KernelPorta kernelPorta();
+
+#endif // _KERNELSIMD_H_
@@ -0,0 +1,266 @@
+#ifndef _LEITORTEXTO_H_
+#define _LEITORTEXTO_H_
+
+#include <string>
+#include <cstddef>
+#include <climits>
+#include <cstring>
+
+/// ###########################################################################
+/// LEITURA RAPIDA DE ARQUIVOS TEXTO
+///
+/// O LeitorTexto percorre um texto que jah estah na memoria (em geral, um
+/// ArquivoMapeado) separando-o em elementos (palavras, numeros inteiros e
+/// caracteres), sempre separados por espacos em branco, como o operator>> das
+/// streams, mas sem a sobrecarga das streams (locale, sentinelas, copias).
+/// Tambem acompanha a linha e a coluna de cada elemento lido, para indicar a
+/// posicao exata de um erro no arquivo.
+/// ###########################################################################
+
+// A descricao do primeiro erro encontrado na leitura de um arquivo
+struct ErroLeitura
+{
+  // Linha e coluna (a partir de 1) do inicio do elemento invalido no arquivo
+  // (0 se o erro nao se refere a uma posicao, como um arquivo que nao pode ser aberto)
+  int linha = 0;
+  int coluna = 0;
+  // O motivo do erro
+  std::string mensagem;
+
+  // Retorna o erro no formato "linha L, coluna C: mensagem"
+  std::string texto() const
+  {
+    if (linha<=0) return mensagem;
+    return "linha " + std::to_string(linha) + ", coluna " + std::to_string(coluna) +
+           ": " + mensagem;
+  }
+};
+
+///
+/// CLASSE LEITOR TEXTO
+///
+
+class LeitorTexto
+{
+private:
+  // O caractere atual e o fim do texto
+  const char* p;
+  const char* fim;
+  // O inicio e o numero da linha atual
+  const char* iniLinha;
+  int linha;
+  // A posicao (linha e coluna) do inicio do ultimo elemento lido
+  int linhaElem;
+  int colunaElem;
+
+  // Retorna true se c eh um espaco em branco (como isspace no locale "C")
+  static bool espaco(char c)
+  {
+    return c==' ' || (c>='\t' && c<='\r');
+  }
+
+public:
+  // Cria o leitor para os N caracteres do texto dados (que devem continuar existindo)
+  LeitorTexto(const char* dados, size_t N):
+    p(dados), fim(dados+N), iniLinha(dados), linha(1), linhaElem(1), colunaElem(1)
+  {
+  }
+
+  // Pula os espacos em branco, contando as linhas, e marca a posicao do proximo elemento
+  void pularEspacos()
+  {
+    while (p<fim && espaco(*p))
+    {
+      if (*p=='\n')
+      {
+        ++linha;
+        iniLinha = p+1;
+      }
+      ++p;
+    }
+    linhaElem = linha;
+    colunaElem = int(p-iniLinha)+1;
+  }
+
+  // Pula o restante da linha atual (usado para os comentarios)
+  void pularLinha()
+  {
+    while (p<fim && *p!='\n') ++p;
+  }
+
+  // Pula os espacos em branco da linha atual, sem passar para a linha seguinte (exceto
+  // depois de uma barra invertida no fim da linha, que continua a linha atual), e
+  // retorna true se a linha acabou: fim de linha, fim do texto ou inicio de comentario
+  // (o caractere "comentario"). Usada nos formatos orientados a linhas.
+  bool fimDeLinha(char comentario)
+  {
+    while (p<fim)
+    {
+      if (*p=='\\')
+      {
+        // Continuacao: barra invertida seguida (talvez de '\r' e) de '\n'
+        const char* q = p+1;
+        if (q<fim && *q=='\r') ++q;
+        if (q<fim && *q=='\n')
+        {
+          p = q+1;
+          ++linha;
+          iniLinha = p;
+          continue;
+        }
+        break;
+      }
+      if (*p=='\n' || !espaco(*p)) break;
+      ++p;
+    }
+    linhaElem = linha;
+    colunaElem = int(p-iniLinha)+1;
+    return p==fim || *p=='\n' || *p==comentario;
+  }
+
+  // Le a sequencia de caracteres s (sem exigir espaco em branco depois dela).
+  // Retorna false (sem consumir nada) se o texto seguinte for diferente.
+  bool lerSequencia(const char* s)
+  {
+    pularEspacos();
+    size_t N = std::strlen(s);
+    if (size_t(fim-p)<N || std::memcmp(p, s, N)!=0) return false;
+    p += N;
+    return true;
+  }
+
+  // Avanca ateh depois da proxima ocorrencia da sequencia s, contando as linhas
+  // (usado para os comentarios de varias linhas).
+  // Retorna false (e vai para o fim do texto) se nao houver mais nenhuma ocorrencia.
+  bool pularAte(const char* s)
+  {
+    size_t N = std::strlen(s);
+    while (size_t(fim-p)>=N)
+    {
+      if (std::memcmp(p, s, N)==0)
+      {
+        p += N;
+        return true;
+      }
+      if (*p=='\n')
+      {
+        ++linha;
+        iniLinha = p+1;
+      }
+      ++p;
+    }
+    p = fim;
+    return false;
+  }
+
+  // Retorna true se nao ha mais elementos (soh espacos em branco ateh o fim do texto)
+  bool acabou()
+  {
+    pularEspacos();
+    return p==fim;
+  }
+
+  // Retorna o proximo caractere que nao eh espaco, sem consumi-lo ('\0' no fim do texto)
+  char espiar()
+  {
+    pularEspacos();
+    return (p<fim ? *p : '\0');
+  }
+
+  // Le um numero inteiro, com sinal opcional.
+  // Retorna false se nao houver um numero ou se ele nao couber em um int.
+  bool lerInteiro(int& x)
+  {
+    pularEspacos();
+    const char* q = p;
+    bool negativo = false;
+    if (q<fim && (*q=='-' || *q=='+')) negativo = (*q++=='-');
+    if (q==fim || *q<'0' || *q>'9') return false;
+    // Acumula em modulo negativo, que tem um valor a mais (INT_MIN)
+    long long v = 0;
+    while (q<fim && *q>='0' && *q<='9')
+    {
+      v = 10*v - (*q++ - '0');
+      if (v < (long long)INT_MIN) return false;
+    }
+    if (!negativo && v < -(long long)INT_MAX) return false;
+    x = int(negativo ? v : -v);
+    p = q;
+    return true;
+  }
+
+  // Le um caractere, que deve ser igual a c.
+  // Retorna false (sem consumir nada) se o proximo caractere for diferente.
+  bool lerCaractere(char c)
+  {
+    pularEspacos();
+    if (p==fim || *p!=c) return false;
+    ++p;
+    return true;
+  }
+
+  // Le uma palavra (sequencia de caracteres sem espacos em branco) em s.
+  // O espaco de s eh reaproveitado entre as leituras.
+  // Retorna false se nao houver mais palavras.
+  bool lerPalavra(std::string& s)
+  {
+    pularEspacos();
+    const char* q = p;
+    while (q<fim && !espaco(*q)) ++q;
+    if (q==p) return false;
+    s.assign(p, q);
+    p = q;
+    return true;
+  }
+
+  // Le um nome: uma sequencia de caracteres sem espacos em branco e sem nenhum dos
+  // caracteres de "delimitadores" (por exemplo, "()=,;" nos formatos de netlist).
+  // O caractere nulo nunca eh delimitador (strchr encontraria o terminador da lista).
+  // Retorna false se o proximo caractere jah for um delimitador ou o fim do texto.
+  bool lerNome(std::string& s, const char* delimitadores)
+  {
+    pularEspacos();
+    const char* q = p;
+    while (q<fim && !espaco(*q) && (*q=='\0' || std::strchr(delimitadores, *q)==nullptr)) ++q;
+    if (q==p) return false;
+    s.assign(p, q);
+    p = q;
+    return true;
+  }
+
+  // Le uma palavra, que deve ser igual a "esperada".
+  // Retorna false (sem consumir nada) se a proxima palavra for diferente.
+  bool lerPalavra(const char* esperada)
+  {
+    pularEspacos();
+    const char* q = p;
+    while (q<fim && *esperada!='\0' && *q==*esperada)
+    {
+      ++q;
+      ++esperada;
+    }
+    if (*esperada!='\0' || (q<fim && !espaco(*q))) return false;
+    p = q;
+    return true;
+  }
+
+  // Linha e coluna (a partir de 1) do inicio do ultimo elemento lido (ou tentado)
+  int getLinha() const
+  {
+    return linhaElem;
+  }
+  int getColuna() const
+  {
+    return colunaElem;
+  }
+
+  // Preenche E com a posicao do ultimo elemento lido (ou tentado) e a mensagem msg
+  void erro(ErroLeitura& E, const std::string& msg) const
+  {
+    E.linha = linhaElem;
+    E.coluna = colunaElem;
+    E.mensagem = msg;
+  }
+};
+
+#endif // _LEITORTEXTO_H_
@@ -1,8 +1,74 @@
 #include "maincircuito.h"
 #include <QApplication>
+#include <iostream>
+#include <cstring>
+#include <string>
+#include "exportartabela.h"
+#include "importar.h"
+#include "pooltrabalho.h"
+
+// Modo em lote, sem a interface grafica: exporta a tabela verdade de um circuito
+//   Circuito --tabela circuito tabela [-b]
+// O circuito pode estar no formato do aplicativo (texto ou binario) ou em um dos
+// formatos de netlist (.bench, .blif, .v). A tabela eh gravada em CSV se o nome
+// terminar em .csv e no formato binario se nao terminar. Com -b, a tabela tem
+// soh as 2^N linhas sem entradas indefinidas. A entrada extra das constantes de
+// uma netlist fica fixa em TRUE e nao aparece na tabela.
+// Sem --tabela como primeiro argumento, os argumentos sao todos do Qt e o
+// aplicativo abre a interface grafica.
+static int exportarEmLote(int argc, char *argv[])
+{
+    std::string arqCircuito, arqTabela;
+    bool binaria = false;
+    bool argumentosOK = true;
+    for (int i=2; i<argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-b")==0) binaria = true;
+        else if (argv[i][0]=='-') argumentosOK = false;
+        else if (arqCircuito.empty()) arqCircuito = argv[i];
+        else if (arqTabela.empty()) arqTabela = argv[i];
+        else argumentosOK = false;
+    }
+    if (!argumentosOK || arqCircuito.empty() || arqTabela.empty())
+    {
+        std::cerr << "Uso: " << argv[0] << " --tabela circuito tabela [-b]\n";
+        return 2;
+    }
+
+    // Leh o circuito: formatos de netlist pela extensao; senao, binario se o arquivo
+    // comecar com a identificacao do formato binario e texto se nao comecar
+    Circuito C;
+    NomesCircuito nomes;
+    ErroLeitura erro;
+    bool leu;
+    if (formatoNetlist(arqCircuito)) leu = importarNetlist(arqCircuito, C, &nomes, &erro);
+    else if (CircuitoCompilado::ehBinario(arqCircuito))
+    {
+        leu = C.lerBinario(arqCircuito);
+        if (!leu) erro.mensagem = "arquivo binario corrompido ou incompativel";
+    }
+    else leu = C.lerRapido(arqCircuito, &erro);
+    if (!leu)
+    {
+        std::cerr << arqCircuito << ": " << erro.texto() << std::endl;
+        return 1;
+    }
+
+    // Gera e grava a tabela, em paralelo com todos os nucleos da CPU
+    PoolTrabalho P;
+    if (!exportarTabela(C, arqTabela, formatoPorExtensao(arqTabela), binaria, &P, &nomes))
+    {
+        std::cerr << "Erro ao exportar a tabela verdade para o arquivo " << arqTabela << std::endl;
+        return 1;
+    }
+    return 0;
+}
 
 int main(int argc, char *argv[])
 {
+    // Com --tabela, roda em lote
+    if (argc>1 && std::strcmp(argv[1], "--tabela")==0) return exportarEmLote(argc, argv);
+
     QApplication a(argc, argv);
     MainCircuito w;
     w.show();
@@ -4,6 +4,9 @@
 #include <QString>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QProgressDialog>
+#include "exportartabela.h"
+#include "pooltrabalho.h"
 
 MainCircuito::MainCircuito(QWidget *parent) :
   QMainWindow(parent),
@@ -430,36 +433,29 @@ void MainCircuito::on_actionGerar_tabela_triggered()
   int numInputs = C.getNumInputs();
   int numOutputs = C.getNumOutputs();
 
-  // vector com as "numInputs" entradas do circuito,
-  // a serem geradas consecutivamente com todas as combinacoes de entrada.
-  // Comeca com todas as entradas bool3S::UNDEF
-  std::vector<bool3S> in_circ(numInputs, bool3S::UNDEF);
-
-  // Linha na tabela verdade (comeca de 1 e nao de 0,
-  // pois a 1a linha eh o pseudocabecalho)
-  int linha=1;
-
-  // Variaveis auxiliares
+  // Variavel auxiliar
   QLabel *prov;
-  int i;
 
   //
-  // Gera todas as combinacoes de entrada e as linhas correspondentes da tabela verdade
+  // Gera todas as combinacoes de entrada e as linhas correspondentes da tabela verdade.
+  // As combinacoes sao geradas em codigo de Gray ternario (cada uma difere da anterior
+  // em uma unica entrada), que eh a ordem mais rapida de simular, mas cada linha eh
+  // exibida na sua posicao na ordem canonica.
   //
-  do
+  C.gerarTabela([&](long long numLinha, const bool3S* in_circ, const bool3S* out_circ)
   {
-    // Chama o metodo de simulacao da classe Circuito,
-    // passando como parametro o vetor de entradas atual.
-    C.simular(in_circ);
+    // Linha na tabela verdade (comeca de 1 e nao de 0,
+    // pois a 1a linha eh o pseudocabecalho)
+    int linha = 1 + int(numLinha);
 
     //
     // Exibe as entradas
     //
-    for (i=0; i<numInputs; ++i)
+    for (int i=0; i<numInputs; ++i)
     {
       // Exibe o valor de cada uma das entradas do circuito
       // na linha "linha" da tabela verdade, nas colunas de 0 a numInputs-1
-      prov = new QLabel( QString( toChar(in_circ.at(i)) ) );
+      prov = new QLabel( QString( toChar(in_circ[i]) ) );
       prov->setAlignment(Qt::AlignCenter);
       ui->tableTabelaVerdade->setCellWidget(linha, i, prov);
     }
@@ -467,31 +463,68 @@ void MainCircuito::on_actionGerar_tabela_triggered()
     //
     // Exibe as saidas
     //
-    for (i=0; i<numOutputs; ++i)
+    for (int i=0; i<numOutputs; ++i)
     {
       // Exibe o valor de cada uma das saidas do circuito
       // na linha "linha" da tabela verdade, nas colunas de numInputs a numInputs+numOutputs-1
-      prov = new QLabel( QString( toChar(C.getOutputCirc(i+1)) ) );
+      prov = new QLabel( QString( toChar(out_circ[i]) ) );
       prov->setAlignment(Qt::AlignCenter);
       ui->tableTabelaVerdade->setCellWidget(linha, i+numInputs, prov);
     }
 
-    // Incrementa a linha da tabela para proxima exibicao
-    ++linha;
+    return true;
+  }, OrdemTabela::GRAY);
+}
 
-    // Gera a proxima combinacao de entrada
-    // Incrementa a ultima entrada que nao for TRUE
-    // Se a ultima for TRUE, tenta incrementar a anterior
-    i = numInputs-1;
-    while (i>=0 && in_circ.at(i)==bool3S::TRUE)
+// Abre uma caixa de dialogo para exportar a tabela verdade para um arquivo.
+// A tabela vai direto para o arquivo, sem passar pela tela, e pode ter qualquer
+// numero de linhas.
+void MainCircuito::on_actionExportar_tabela_triggered()
+{
+  // Soh pode simular se o Circuito for valido
+  if (!C.valid())
+  {
+    QMessageBox::critical(this, "Erro de simulacao", "O Circuito nao esta completamente definido.\nNao pode ser simulado.");
+    return;
+  }
+
+  QString fileName = QFileDialog::getSaveFileName(this, "Arquivo da tabela verdade", "",
+                                                  "Texto CSV (*.csv);;Binario (*.tab);;Todos (*.*)");
+
+  if (!fileName.isEmpty()) {
+    // Pergunta se a tabela deve ter todas as 3^N linhas ou soh as 2^N sem entradas indefinidas
+    bool binaria = (QMessageBox::question(this, "Exportar tabela",
+                                          "Exportar somente as linhas sem entradas indefinidas (?)") == QMessageBox::Yes);
+
+    // Janela de progresso, com a opcao de cancelar a exportacao.
+    // Ela eh atualizada pelo acompanhamento da exportacao, que roda nesta thread:
+    // como a janela eh modal, setValue processa os eventos (inclusive o botao Cancelar).
+    QProgressDialog progresso("Exportando a tabela verdade...", "Cancelar", 0, 1000, this);
+    progresso.setWindowModality(Qt::WindowModal);
+    progresso.setMinimumDuration(500);
+    auto acompanhar = [&progresso](long long feitas, long long total)
     {
-      ++in_circ.at(i);
-      --i;
+      progresso.setValue(int(1000.0*double(feitas)/double(total)));
+      return !progresso.wasCanceled();
     };
-    // Incrementa a input selecionada
-    if (i>=0) ++in_circ.at(i);
 
-  } while (i>=0);
+    // Gera e grava a tabela, em paralelo com todos os nucleos da CPU
+    PoolTrabalho P;
+    std::string arq = fileName.toStdString();
+    if (!exportarTabela(C, arq, formatoPorExtensao(arq), binaria, &P, nullptr, acompanhar))
+    {
+      if (progresso.wasCanceled())
+      {
+        // Cancelada pelo usuario: o arquivo incompleto jah foi apagado
+        QMessageBox::information(this, "Exportar tabela", "Exportacao cancelada.");
+      }
+      else
+      {
+        // Exibe uma msg de erro na escrita
+        QMessageBox::critical(this, "Erro de escrita", "Erro ao exportar a tabela verdade para o arquivo:\n"+fileName);
+      }
+    }
+  }
 }
 
 // Exibe a caixa de dialogo para fixar caracteristicas de uma porta
@@ -54,6 +54,9 @@ private slots:
   // Chama a funcao simular da classe Circuito
   void on_actionGerar_tabela_triggered();
 
+  // Abre uma caixa de dialogo para exportar a tabela verdade para um arquivo
+  void on_actionExportar_tabela_triggered();
+
   // Exibe a caixa de dialogo para fixar caracteristicas de uma porta
   void on_tablePortas_activated(const QModelIndex &index);
 
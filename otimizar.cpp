@@ -0,0 +1,507 @@
+#include <algorithm>
+#include <unordered_set>
+#include <iomanip>
+#include "otimizar.h"
+
+/// ***********************
+/// Funcoes auxiliares
+/// ***********************
+
+// Retorna o sinal que representa o sinal s, seguindo a cadeia de substituicoes em equiv
+// (e encurtando-a pela metade a cada passo)
+static int raiz(std::vector<int>& equiv, int s)
+{
+  while (equiv[s] != s)
+  {
+    equiv[s] = equiv[equiv[s]];
+    s = equiv[s];
+  }
+  return s;
+}
+
+// Um circuito durante uma otimizacao, nos indices de sinais do circuito compilado original
+// (sinais de 0 a NI-1: entradas; de NI a NI+NP-1: portas). As portas criadas pela propria
+// otimizacao recebem os indices seguintes (NP, NP+1, ...).
+struct RedeOtimizacao
+{
+  // O sinal que substitui cada sinal (equiv[s]==s se s for mantido, inclusive as entradas)
+  std::vector<int> equiv;
+  // Indica as portas mantidas no circuito otimizado
+  std::vector<char> manter;
+  // Tipo de cada porta mantida e origens (sinais mantidos) das suas entradas:
+  // orig[ini[i]] ... orig[ini[i]+Nin[i]-1]
+  std::vector<TipoPorta> tipo;
+  std::vector<int> ini;
+  std::vector<int> Nin;
+  std::vector<int> orig;
+
+  // Inicia a rede com as portas do circuito CC, todas mantidas e sem alteracoes
+  explicit RedeOtimizacao(const CircuitoCompilado& CC);
+
+  // Acrescenta uma porta do tipo T com as entradas vindas dos sinais in[0] ... in[N-1].
+  // Retorna o indice do sinal da nova porta.
+  int novaPorta(TipoPorta T, const int* in, int N);
+};
+
+// Inicia a rede com as portas do circuito CC
+RedeOtimizacao::RedeOtimizacao(const CircuitoCompilado& CC):
+  equiv(CC.getNumSinais()),
+  manter(CC.getNumPorts(), 1),
+  tipo(CC.getNumPorts()),
+  ini(CC.getNumPorts()),
+  Nin(CC.getNumPorts()),
+  orig(CC.getNumConexoes())
+{
+  for (int s=0; s<CC.getNumSinais(); ++s) equiv[s] = s;
+  int k = 0;
+  for (int i=0; i<CC.getNumPorts(); ++i)
+  {
+    tipo[i] = CC.getTipoPort(i);
+    ini[i] = k;
+    Nin[i] = CC.getNumInputsPort(i);
+    for (int j=0; j<Nin[i]; ++j) orig[k++] = CC.getSinalInPort(i, j);
+  }
+}
+
+// Acrescenta uma porta a rede
+int RedeOtimizacao::novaPorta(TipoPorta T, const int* in, int N)
+{
+  int s = int(equiv.size());
+  equiv.push_back(s);
+  manter.push_back(1);
+  tipo.push_back(T);
+  ini.push_back(int(orig.size()));
+  Nin.push_back(N);
+  orig.insert(orig.end(), in, in+N);
+  return s;
+}
+
+// Monta em R o circuito otimizado descrito pela rede Q, obtida a partir do circuito
+// compilado original CC
+static void montarResultado(const CircuitoCompilado& CC, const RedeOtimizacao& Q,
+                            ResultadoOtimizacao& R)
+{
+  const int NI = CC.getNumInputs();
+  const int NO = CC.getNumOutputs();
+  const int NP = CC.getNumPorts();
+  const int NPrede = int(Q.tipo.size());
+
+  // Ids das portas mantidas no circuito otimizado, na ordem dos indices da rede
+  std::vector<int> novaId(NPrede, 0);
+  int NPnovo = 0;
+  for (int i=0; i<NPrede; ++i) if (Q.manter[i]) novaId[i] = ++NPnovo;
+  // Id de origem, no circuito otimizado, de um sinal da rede (0 se ele nao foi mantido)
+  auto idNova = [&](int s) { return (s<NI ? -s-1 : novaId[s-NI]); };
+
+  // Um circuito valido tem pelo menos uma porta: se todas foram eliminadas (todas as
+  // saidas vem de entradas), cria um inversor da primeira entrada, que nao eh usado
+  R.NconexoesDepois = 0;
+  Circuito C(NI, NO, std::max(NPnovo, 1));
+  if (NPnovo==0)
+  {
+    std::string nome = nomePorta(TipoPorta::NT);
+    C.setPort(1, nome, 1);
+    C.setIdInPort(1, 0, -1);
+    R.NconexoesDepois = 1;
+  }
+  for (int i=0; i<NPrede; ++i)
+  {
+    if (novaId[i]==0) continue;
+    std::string nome = nomePorta(Q.tipo[i]);
+    C.setPort(novaId[i], nome, Q.Nin[i]);
+    for (int k=0; k<Q.Nin[i]; ++k) C.setIdInPort(novaId[i], k, idNova(Q.orig[Q.ini[i]+k]));
+    R.NconexoesDepois += Q.Nin[i];
+  }
+  for (int j=0; j<NO; ++j) C.setIdOutputCirc(j+1, idNova(Q.equiv[CC.getSinalOutCirc(j)]));
+
+  R.mapa.resize(NP);
+  for (int i=0; i<NP; ++i) R.mapa[i] = idNova(Q.equiv[NI+i]);
+  R.NportasAntes = NP;
+  R.NportasDepois = C.getNumPorts();
+  R.NconexoesAntes = CC.getNumConexoes();
+  R.circ = std::move(C);
+}
+
+/// ***********************
+/// RELATORIO
+/// ***********************
+
+// Escreve uma linha do relatorio: antes, depois e reducao percentual
+static void escreverReducao(std::ostream& O, const char* nome, int antes, int depois)
+{
+  O << nome << ": " << antes << " -> " << depois;
+  if (antes>0)
+  {
+    O << " (-" << std::fixed << std::setprecision(1)
+      << 100.0*(antes-depois)/antes << "%)";
+  }
+  O << std::endl;
+}
+
+// Escreve um resumo da reducao
+std::ostream& ResultadoOtimizacao::escreverRelatorio(std::ostream& O) const
+{
+  escreverReducao(O, "Portas", NportasAntes, NportasDepois);
+  escreverReducao(O, "Conexoes", NconexoesAntes, NconexoesDepois);
+  return O;
+}
+
+/// ***********************
+/// HASH ESTRUTURAL
+/// ***********************
+
+// A forma canonica das portas durante o hash estrutural: o tipo de cada porta e as
+// origens das suas entradas (jah substituidas pelos representantes), em ordem crescente
+struct HashForma
+{
+  const RedeOtimizacao* Q;
+  size_t operator()(int i) const
+  {
+    size_t h = size_t(Q->tipo[i]);
+    for (int k=Q->ini[i]; k<Q->ini[i]+Q->Nin[i]; ++k)
+    {
+      h ^= size_t(Q->orig[k]) + 0x9e3779b97f4a7c15ULL + (h<<6) + (h>>2);
+    }
+    return h;
+  }
+};
+
+// Testa se as portas de indices i e j tem a mesma forma canonica
+struct IgualForma
+{
+  const RedeOtimizacao* Q;
+  bool operator()(int i, int j) const
+  {
+    const int* oi = Q->orig.data()+Q->ini[i];
+    const int* oj = Q->orig.data()+Q->ini[j];
+    return (Q->tipo[i]==Q->tipo[j] && Q->Nin[i]==Q->Nin[j] &&
+            std::equal(oi, oi+Q->Nin[i], oj));
+  }
+};
+
+// Elimina as portas duplicadas
+bool hashEstrutural(const Circuito& C, ResultadoOtimizacao& R)
+{
+  // A copia compartilha a estrutura (e a representacao compilada) de C
+  Circuito copia(C);
+  if (!copia.valid()) return false;
+  const CircuitoCompilado& CC = copia.getCompilado();
+  const int NI = CC.getNumInputs();
+  const int NP = CC.getNumPorts();
+
+  RedeOtimizacao Q(CC);
+  std::unordered_set<int, HashForma, IgualForma> tabela(2*size_t(NP), HashForma{&Q}, IgualForma{&Q});
+  bool mudou;
+  do
+  {
+    mudou = false;
+    tabela.clear();
+    for (int i : CC.getOrdem())
+    {
+      if (raiz(Q.equiv, NI+i) != NI+i) continue;
+      // Forma canonica: as entradas substituidas pelos representantes e ordenadas
+      int* in = Q.orig.data()+Q.ini[i];
+      for (int k=0; k<Q.Nin[i]; ++k) in[k] = raiz(Q.equiv, in[k]);
+      std::sort(in, in+Q.Nin[i]);
+      // Se jah existe uma porta com a mesma forma, esta porta eh uma duplicata
+      auto ins = tabela.insert(i);
+      if (!ins.second)
+      {
+        Q.equiv[NI+i] = NI+*ins.first;
+        Q.manter[i] = 0;
+        mudou = true;
+      }
+    }
+    // Sem lacos, as entradas de cada porta jah estao definitivas quando ela eh visitada:
+    // uma passagem basta
+  } while (mudou && CC.possuiCiclo());
+
+  // Entradas e saidas definitivas (uma porta de um laco pode ter sido visitada antes
+  // da substituicao das suas entradas)
+  for (int s=0; s<NI+NP; ++s) raiz(Q.equiv, s);
+  for (int i=0; i<NP; ++i)
+  {
+    if (!Q.manter[i]) continue;
+    for (int k=Q.ini[i]; k<Q.ini[i]+Q.Nin[i]; ++k) Q.orig[k] = Q.equiv[Q.orig[k]];
+  }
+  montarResultado(CC, Q, R);
+  return true;
+}
+
+/// ***********************
+/// SIMPLIFICACAO
+/// ***********************
+
+// Os operadores logicos das portas, sem a negacao da saida
+enum class OperadorPorta
+{
+  NOT, AND, OR, XOR
+};
+
+// Retorna o operador de uma porta e se a sua saida eh negada
+static OperadorPorta operadorPorta(TipoPorta T, bool& negada)
+{
+  negada = (T==TipoPorta::NT || T==TipoPorta::NA || T==TipoPorta::NO || T==TipoPorta::NX);
+  switch (T)
+  {
+  case TipoPorta::AN:
+  case TipoPorta::NA:
+    return OperadorPorta::AND;
+  case TipoPorta::OR:
+  case TipoPorta::NO:
+    return OperadorPorta::OR;
+  case TipoPorta::XO:
+  case TipoPorta::NX:
+    return OperadorPorta::XOR;
+  default:
+    return OperadorPorta::NOT;
+  }
+}
+
+// Retorna o tipo de porta com o operador Op, negada ou nao (Op nao pode ser NOT)
+static TipoPorta tipoOperador(OperadorPorta Op, bool negada)
+{
+  switch (Op)
+  {
+  case OperadorPorta::AND:
+    return (negada ? TipoPorta::NA : TipoPorta::AN);
+  case OperadorPorta::OR:
+    return (negada ? TipoPorta::NO : TipoPorta::OR);
+  default:
+    return (negada ? TipoPorta::NX : TipoPorta::XO);
+  }
+}
+
+// Propaga as constantes e elimina as portas inuteis
+bool simplificar(const Circuito& C, const std::vector<int>& IdFixas,
+                 const std::vector<bool3S>& valoresFixos, ResultadoOtimizacao& R)
+{
+  // A copia compartilha a estrutura (e a representacao compilada) de C
+  Circuito copia(C);
+  if (!copia.valid() || IdFixas.size()!=valoresFixos.size()) return false;
+  for (int id : IdFixas) if (!copia.validIdInputCirc(id)) return false;
+  const CircuitoCompilado& CC = copia.getCompilado();
+  const int NI = CC.getNumInputs();
+  const int NO = CC.getNumOutputs();
+  const int NP = CC.getNumPorts();
+  const int NS = NI+NP;
+
+  // Valor de cada sinal constante (-1 se o sinal nao for constante) e, para cada valor,
+  // o sinal que o fornece no circuito otimizado: uma entrada fixada com esse valor
+  // (-1 se nao houver)
+  std::vector<signed char> cte(NS, -1);
+  int fonte[3] = {-1, -1, -1};
+  for (size_t k=0; k<IdFixas.size(); ++k)
+  {
+    int s = -IdFixas[k]-1;
+    cte[s] = (signed char)(valoresFixos[k]);
+    if (fonte[cte[s]]<0) fonte[cte[s]] = s;
+  }
+  // Um valor constante pode ser fornecido se alguma entrada fixada tiver esse valor
+  // ou o valor oposto (com uma porta NT); UNDEF soh pode vir de uma entrada UNDEF
+  auto fornecivel = [&](bool3S c)
+  {
+    return (fonte[int(c)]>=0 || (c!=bool3S::UNDEF && fonte[int(~c)]>=0));
+  };
+
+  // Os sinais constantes:
+  // - os que tem valor definido quando as entradas livres sao UNDEF: como as portas sao
+  //   monotonas, o valor nao muda para nenhum valor das entradas livres
+  // - os que nao dependem de nenhuma entrada livre
+  std::vector<bool3S> in(NI, bool3S::UNDEF);
+  for (size_t k=0; k<IdFixas.size(); ++k) in[-IdFixas[k]-1] = valoresFixos[k];
+  std::vector<bool3S> V(NS);
+  CC.simular(in.data(), V.data());
+
+  std::vector<char> livre(NS, 0);
+  for (int s=0; s<NI; ++s) livre[s] = (cte[s]<0);
+  bool mudou;
+  do
+  {
+    mudou = false;
+    for (int i : CC.getOrdem())
+    {
+      if (livre[NI+i]) continue;
+      for (int k=0; k<CC.getNumInputsPort(i); ++k)
+      {
+        if (livre[CC.getSinalInPort(i, k)])
+        {
+          livre[NI+i] = mudou = true;
+          break;
+        }
+      }
+    }
+  } while (mudou && CC.possuiCiclo());
+
+  for (int s=NI; s<NS; ++s)
+  {
+    if ((!livre[s] || V[s]!=bool3S::UNDEF) && fornecivel(V[s])) cte[s] = (signed char)(V[s]);
+  }
+
+  // Reescreve as portas em ordem topologica, ja com as entradas substituidas pelos
+  // seus representantes:
+  // - entradas constantes neutras sao retiradas (TRUE no AND, FALSE no OR e no XOR;
+  //   TRUE no XOR inverte a saida) e as absorventes tornam a porta constante
+  // - portas com uma unica entrada restante viram buffers (substituidos pela entrada)
+  //   ou inversores
+  // - um inversor de um inversor eh substituido pela entrada do primeiro
+  RedeOtimizacao Q(CC);
+  std::vector<char> processada(NP, 0);
+  std::vector<int> L;
+  for (int i : CC.getOrdem())
+  {
+    const int s = NI+i;
+    Q.manter[i] = 0;
+    if (cte[s]>=0) continue;
+
+    bool negada;
+    OperadorPorta Op = operadorPorta(Q.tipo[i], negada);
+    bool constante = false;
+    bool3S valor = bool3S::UNDEF;
+    L.clear();
+    for (int k=0; k<Q.Nin[i] && !constante; ++k)
+    {
+      int r = raiz(Q.equiv, Q.orig[Q.ini[i]+k]);
+      if (cte[r]<0)
+      {
+        L.push_back(r);
+        continue;
+      }
+      bool3S c = bool3S(cte[r]);
+      switch (Op)
+      {
+      case OperadorPorta::NOT:
+        constante = true;
+        break;
+      case OperadorPorta::AND:
+        if (c==bool3S::FALSE) constante = true;
+        else if (c==bool3S::UNDEF) L.push_back(r);
+        break;
+      case OperadorPorta::OR:
+        if (c==bool3S::TRUE) constante = true;
+        else if (c==bool3S::UNDEF) L.push_back(r);
+        break;
+      case OperadorPorta::XOR:
+        if (c==bool3S::UNDEF) constante = true;
+        else if (c==bool3S::TRUE) negada = !negada;
+        break;
+      }
+      if (constante) valor = c;
+    }
+    if (!constante)
+    {
+      // Sem entradas restantes: o elemento neutro do operador
+      if (L.empty())
+      {
+        constante = true;
+        valor = (Op==OperadorPorta::AND ? bool3S::TRUE : bool3S::FALSE);
+      }
+      // Apenas entradas UNDEF constantes (no AND e no OR): a saida tambem eh UNDEF
+      else if (std::all_of(L.begin(), L.end(), [&](int r) { return cte[r]>=0; }))
+      {
+        constante = true;
+        valor = bool3S::UNDEF;
+      }
+    }
+    if (constante)
+    {
+      cte[s] = (signed char)(negada ? ~valor : valor);
+      continue;
+    }
+
+    int* dest = Q.orig.data()+Q.ini[i];
+    if (Op==OperadorPorta::NOT || L.size()==1)
+    {
+      int x = L[0];
+      if (!negada)
+      {
+        // Buffer: substituido pela sua entrada, exceto se ela for a propria porta
+        // (um laco de buffers, que eh sempre UNDEF: a porta vira um AND da saida com ela mesma)
+        if (x!=s) Q.equiv[s] = x;
+        else
+        {
+          Q.manter[i] = 1;
+          Q.tipo[i] = TipoPorta::AN;
+          Q.Nin[i] = 2;
+          dest[0] = dest[1] = s;
+        }
+      }
+      else
+      {
+        // Inversor de um inversor: substituido pela entrada do primeiro
+        int y = -1;
+        if (x>=NI && processada[x-NI] && Q.manter[x-NI] && Q.tipo[x-NI]==TipoPorta::NT)
+        {
+          y = raiz(Q.equiv, Q.orig[Q.ini[x-NI]]);
+        }
+        if (y>=0 && y!=s) Q.equiv[s] = y;
+        else
+        {
+          Q.manter[i] = 1;
+          Q.tipo[i] = TipoPorta::NT;
+          Q.Nin[i] = 1;
+          dest[0] = x;
+        }
+      }
+    }
+    else
+    {
+      Q.manter[i] = 1;
+      Q.tipo[i] = tipoOperador(Op, negada);
+      Q.Nin[i] = int(L.size());
+      std::copy(L.begin(), L.end(), dest);
+    }
+    processada[i] = 1;
+  }
+
+  // As portas que influenciam alguma saida: percorre as conexoes a partir das saidas,
+  // marcando tambem os valores constantes que precisam ser fornecidos
+  std::vector<char> viva(NP, 0);
+  bool usada[3] = {false, false, false};
+  std::vector<int> pilha;
+  auto visitar = [&](int r)
+  {
+    if (r<NI) return;
+    if (cte[r]>=0) usada[cte[r]] = true;
+    else if (!viva[r-NI])
+    {
+      viva[r-NI] = 1;
+      pilha.push_back(r-NI);
+    }
+  };
+  for (int j=0; j<NO; ++j) visitar(raiz(Q.equiv, CC.getSinalOutCirc(j)));
+  while (!pilha.empty())
+  {
+    int i = pilha.back();
+    pilha.pop_back();
+    for (int k=Q.ini[i]; k<Q.ini[i]+Q.Nin[i]; ++k) visitar(raiz(Q.equiv, Q.orig[k]));
+  }
+
+  // Os valores constantes usados que nenhuma entrada fixada fornece diretamente
+  // sao obtidos com um inversor de uma entrada com o valor oposto
+  for (int c=0; c<3; ++c)
+  {
+    if (usada[c] && fonte[c]<0 && c!=int(bool3S::UNDEF))
+    {
+      int oposta = fonte[int(~bool3S(c))];
+      fonte[c] = Q.novaPorta(TipoPorta::NT, &oposta, 1);
+    }
+  }
+
+  // O sinal mantido que substitui cada sinal: as portas constantes sao substituidas
+  // pela fonte do seu valor (se houver)
+  auto substituto = [&](int s)
+  {
+    int r = raiz(Q.equiv, s);
+    return ((r>=NI && r<NS && cte[r]>=0 && fonte[cte[r]]>=0) ? fonte[cte[r]] : r);
+  };
+  for (int i=0; i<NP; ++i)
+  {
+    Q.manter[i] = Q.manter[i] && viva[i];
+    if (!Q.manter[i]) continue;
+    for (int k=Q.ini[i]; k<Q.ini[i]+Q.Nin[i]; ++k) Q.orig[k] = substituto(Q.orig[k]);
+  }
+  for (int s=NI; s<NS; ++s) Q.equiv[s] = substituto(s);
+  montarResultado(CC, Q, R);
+  return true;
+}
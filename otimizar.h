@@ -0,0 +1,73 @@
+#ifndef _OTIMIZAR_H_
+#define _OTIMIZAR_H_
+
+#include <iostream>
+#include <vector>
+#include "circuito.h"
+
+/// ###########################################################################
+/// OTIMIZACOES DE CIRCUITOS
+///
+/// Cada otimizacao recebe um circuito valido e produz um circuito equivalente,
+/// com menos portas: para quaisquer entradas, as saidas simuladas sao identicas
+/// (inclusive os valores UNDEF e o ponto fixo dos lacos). As portas do circuito
+/// otimizado sao numeradas na mesma ordem relativa das portas originais.
+/// Como um circuito valido tem pelo menos uma porta, se todas forem eliminadas
+/// o circuito otimizado fica com um inversor da primeira entrada, nao usado.
+/// ###########################################################################
+
+// O resultado de uma otimizacao
+struct ResultadoOtimizacao
+{
+  // O circuito otimizado
+  Circuito circ;
+  // A origem, no circuito otimizado, equivalente a cada porta do circuito original
+  // (dimensao igual ao numero de portas do original): a saida da porta de id "id" do
+  // original eh sempre igual ao sinal de id mapa[id-1] do otimizado (uma porta ou uma
+  // entrada do circuito), ou 0 se a porta foi eliminada sem equivalente
+  std::vector<int> mapa;
+  // Numero de portas e de conexoes (entradas de portas) antes e depois da otimizacao
+  int NportasAntes = 0;
+  int NportasDepois = 0;
+  int NconexoesAntes = 0;
+  int NconexoesDepois = 0;
+
+  // Escreve um resumo da reducao (numero de portas e de conexoes)
+  std::ostream& escreverRelatorio(std::ostream& O=std::cout) const;
+};
+
+// Hash estrutural: elimina as portas duplicadas (mesmo tipo e mesmas origens das entradas,
+// em qualquer ordem, jah que todas as portas sao comutativas). Cada porta eh representada
+// na forma canonica (tipo, origens ordenadas) e procurada em uma tabela hash de portas
+// jah vistas, percorrendo as portas em ordem topologica; as duplicatas sao substituidas
+// pela primeira porta equivalente em todas as conexoes e saidas. Como as duplicatas
+// de portas anteriores jah foram substituidas, duplicatas em cascata tambem sao
+// eliminadas. Nos lacos, a passagem eh repetida ateh que nada mude (portas de lacos
+// distintos que soh seriam equivalentes por causa umas das outras sao mantidas).
+// Retorna false (e nao altera R) se o circuito C for invalido.
+bool hashEstrutural(const Circuito& C, ResultadoOtimizacao& R);
+
+// Simplificacao: propaga as constantes e elimina as portas inuteis.
+// As entradas de ids IdFixas (-1, -2, etc.) sao fixadas nos valores valoresFixos
+// (mesma dimensao); as demais entradas sao livres. O circuito simplificado tem as mesmas
+// entradas e produz as mesmas saidas do original para quaisquer valores das entradas
+// livres, desde que as entradas fixadas recebam os valores fixados. Sao feitas:
+// - propagacao das constantes: as portas cuja saida nao depende das entradas livres sao
+//   substituidas pelo seu valor (fornecido por uma entrada fixada com esse valor ou, se
+//   nao houver, por um inversor de uma entrada com o valor oposto); as entradas
+//   constantes que nao alteram a saida de uma porta sao retiradas
+// - eliminacao de buffers (portas com uma unica entrada restante) e de inversores duplos
+// - eliminacao das portas que nao influenciam nenhuma saida do circuito
+// Em R.mapa, as portas eliminadas que nao tem equivalente no circuito simplificado
+// (porque nao influenciavam as saidas) ficam com 0.
+// Retorna false (e nao altera R) se o circuito C ou alguma entrada fixada forem invalidos.
+bool simplificar(const Circuito& C, const std::vector<int>& IdFixas,
+                 const std::vector<bool3S>& valoresFixos, ResultadoOtimizacao& R);
+
+// Simplificacao sem entradas fixadas
+inline bool simplificar(const Circuito& C, ResultadoOtimizacao& R)
+{
+  return simplificar(C, std::vector<int>(), std::vector<bool3S>(), R);
+}
+
+#endif // _OTIMIZAR_H_
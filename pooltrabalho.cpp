@@ -0,0 +1,125 @@
+#include <algorithm>
+#include "pooltrabalho.h"
+
+///
+/// CLASSE POOL TRABALHO
+///
+
+// Cria o pool e inicia as threads, que ficam aguardando o primeiro lote
+PoolTrabalho::PoolTrabalho(int Nthreads):
+  threads(),
+  faixas(Nthreads>0 ? Nthreads : std::max(1u, std::thread::hardware_concurrency())),
+  tarefa(nullptr),
+  lote(0),
+  ativas(0),
+  encerrar(false)
+{
+  for (int t=0; t<int(faixas.size()); ++t)
+  {
+    threads.emplace_back(&PoolTrabalho::trabalhar, this, t);
+  }
+}
+
+// Encerra as threads
+PoolTrabalho::~PoolTrabalho()
+{
+  {
+    std::lock_guard<std::mutex> lock(trava);
+    encerrar = true;
+  }
+  inicio.notify_all();
+  for (auto& t : threads) t.join();
+}
+
+// Retira uma tarefa da propria faixa (a primeira) ou rouba de outra thread (a ultima)
+int PoolTrabalho::obterTarefa(int thread)
+{
+  int N = int(faixas.size());
+  for (int k=0; k<N; ++k)
+  {
+    int dono = (thread+k)%N;
+    Faixa& F = faixas[dono];
+    std::lock_guard<std::mutex> lock(F.trava);
+    if (F.ini < F.fim)
+    {
+      return (dono==thread ? F.ini++ : --F.fim);
+    }
+  }
+  return -1;
+}
+
+// Laco principal de cada thread do pool
+void PoolTrabalho::trabalhar(int thread)
+{
+  long ultimoLote = 0;
+  while (true)
+  {
+    // Aguarda um novo lote (ou o encerramento)
+    {
+      std::unique_lock<std::mutex> lock(trava);
+      inicio.wait(lock, [&]{ return encerrar || lote!=ultimoLote; });
+      if (encerrar) return;
+      ultimoLote = lote;
+    }
+
+    // Executa tarefas ateh nao haver mais nenhuma em nenhuma faixa
+    int t;
+    while ((t = obterTarefa(thread)) >= 0) (*tarefa)(t, thread);
+
+    // Avisa que terminou
+    {
+      std::lock_guard<std::mutex> lock(trava);
+      if (--ativas == 0) termino.notify_all();
+    }
+  }
+}
+
+// Executa as tarefas de 0 a Ntarefas-1 e soh retorna quando todas terminarem
+void PoolTrabalho::executar(int Ntarefas, const Tarefa& T)
+{
+  if (Ntarefas <= 0) return;
+  iniciar(Ntarefas, T);
+
+  // Aguarda todas as threads terminarem (sem executar tarefas nesta thread)
+  std::unique_lock<std::mutex> lock(trava);
+  termino.wait(lock, [&]{ return ativas==0; });
+  tarefa = nullptr;
+}
+
+// Distribui as tarefas de 0 a Ntarefas-1 e retorna sem aguardar
+void PoolTrabalho::iniciar(int Ntarefas, const Tarefa& T)
+{
+  if (Ntarefas <= 0) return;
+  int N = int(faixas.size());
+
+  // Divide as tarefas em faixas contiguas, uma para cada thread
+  for (int t=0; t<N; ++t)
+  {
+    std::lock_guard<std::mutex> lock(faixas[t].trava);
+    faixas[t].ini = int((long long)Ntarefas*t/N);
+    faixas[t].fim = int((long long)Ntarefas*(t+1)/N);
+  }
+
+  // Inicia o lote
+  std::lock_guard<std::mutex> lock(trava);
+  tarefa = &T;
+  ativas = N;
+  ++lote;
+  inicio.notify_all();
+}
+
+// Executa tarefas do lote iniciado ateh elas acabarem e aguarda todas terminarem
+void PoolTrabalho::aguardar()
+{
+  // tarefa soh eh alterada pela thread que chama iniciar e aguardar
+  if (tarefa == nullptr) return;
+
+  // Esta thread rouba tarefas como a thread de numero getNumThreads()
+  int N = int(faixas.size());
+  int t;
+  while ((t = obterTarefa(N)) >= 0) (*tarefa)(t, N);
+
+  std::unique_lock<std::mutex> lock(trava);
+  termino.wait(lock, [&]{ return ativas==0; });
+  tarefa = nullptr;
+}
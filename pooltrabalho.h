@@ -0,0 +1,89 @@
+#ifndef _POOLTRABALHO_H_
+#define _POOLTRABALHO_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+///
+/// CLASSE POOL TRABALHO
+///
+/// Conjunto fixo de threads que executa lotes de tarefas independentes,
+/// numeradas de 0 a Ntarefas-1, com roubo de trabalho ("work stealing"):
+/// cada thread recebe inicialmente uma faixa contigua de tarefas e as executa
+/// em ordem crescente; quando a sua faixa acaba, rouba a ultima tarefa da faixa
+/// de outra thread. Assim, a carga se equilibra mesmo quando as tarefas
+/// tem duracoes diferentes.
+///
+
+class PoolTrabalho
+{
+public:
+  // A funcao que executa uma tarefa: recebe o numero da tarefa e o numero
+  // (de 0 a getNumThreads()-1) da thread que a estah executando.
+  using Tarefa = std::function<void(int tarefa, int thread)>;
+
+private:
+  // A faixa de tarefas ainda nao executadas de uma thread: [ini, fim)
+  struct Faixa
+  {
+    std::mutex trava;
+    int ini = 0;
+    int fim = 0;
+  };
+
+  // As threads e as suas faixas de tarefas
+  std::vector<std::thread> threads;
+  std::vector<Faixa> faixas;
+
+  // Sincronizacao entre a thread que chama executar e as threads do pool
+  std::mutex trava;
+  std::condition_variable inicio;
+  std::condition_variable termino;
+  // Lote atual: funcao de execucao, numero do lote (para acordar as threads)
+  // e numero de threads que ainda nao terminaram o lote
+  const Tarefa* tarefa;
+  long lote;
+  int ativas;
+  bool encerrar;
+
+  // Laco principal de cada thread do pool
+  void trabalhar(int thread);
+
+  // Retira uma tarefa da faixa da propria thread ou, se ela estiver vazia,
+  // rouba uma tarefa de outra thread. Retorna -1 se nao houver mais tarefas.
+  // A thread que chama aguardar (thread==getNumThreads()) nao tem faixa e soh rouba.
+  int obterTarefa(int thread);
+
+public:
+  // Cria o pool com Nthreads threads (se Nthreads<=0, usa o numero de nucleos da CPU)
+  explicit PoolTrabalho(int Nthreads=0);
+  // Encerra as threads
+  ~PoolTrabalho();
+
+  PoolTrabalho(const PoolTrabalho&) = delete;
+  PoolTrabalho& operator=(const PoolTrabalho&) = delete;
+
+  // Numero de threads do pool
+  int getNumThreads() const
+  {
+    return int(threads.size());
+  }
+
+  // Executa as tarefas de 0 a Ntarefas-1 e soh retorna quando todas terminarem
+  void executar(int Ntarefas, const Tarefa& T);
+
+  // Execucao em duas etapas, para que a thread que chama faca outro trabalho enquanto
+  // o lote eh executado: iniciar distribui as tarefas de 0 a Ntarefas-1 e retorna
+  // imediatamente; aguardar soh retorna quando todas terminarem. T tem que existir ateh
+  // aguardar retornar, e cada iniciar tem que ser seguido por um aguardar antes do
+  // proximo lote.
+  // Em aguardar, a thread que chama tambem executa as tarefas que ainda nao comecaram,
+  // com o numero de thread getNumThreads(): T deve aceitar getNumThreads()+1 threads.
+  void iniciar(int Ntarefas, const Tarefa& T);
+  void aguardar();
+};
+
+#endif // _POOLTRABALHO_H_
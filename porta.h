@@ -4,6 +4,83 @@
 #include <string>
 #include <vector>
 #include "bool3S.h"
+#include "dominiovalor.h"
+
+///
+/// OS TIPOS DE PORTA
+///
+
+// Codificacao compacta (1 byte) do tipo de uma porta.
+// Usada nas representacoes do circuito em que as portas nao sao objetos polimorficos.
+enum class TipoPorta : unsigned char
+{
+  NT, AN, NA, OR, NO, XO, NX
+};
+
+// Retorna a sigla de um tipo de porta (NT, AN, etc.)
+std::string nomePorta(TipoPorta tipo);
+// Obtem o tipo de porta cuja sigla eh "nome" (NT, AN, etc., em maiusculas).
+// Retorna false se a sigla for invalida.
+bool tipoPorta(const std::string& nome, TipoPorta& tipo);
+
+///
+/// A AVALIACAO DAS PORTAS
+///
+/// Funcao logica de cada tipo de porta, sem objetos Porta nem chamadas virtuais.
+/// Eh escrita uma unica vez para todos os dominios de valores (dominiovalor.h) e
+/// usada tanto pela classe Porta quanto pelas representacoes compiladas do circuito.
+/// As portas negadas (NT, NA, NO, NX) sao avaliadas diretamente, sem portas temporarias.
+///
+
+// Avalia uma porta do tipo "tipo" com N entradas (N>=1) no dominio de valores T.
+// O valor da k-esima entrada (k de 0 a N-1) eh obtido por entrada(k).
+template <class T, class Entrada>
+inline T avaliarPorta(TipoPorta tipo, int N, Entrada entrada)
+{
+  using D = DominioValor<T>;
+  T result = entrada(0);
+  int k = 0;
+
+  switch (tipo)
+  {
+  case TipoPorta::NT:
+    break;
+  case TipoPorta::AN:
+  case TipoPorta::NA:
+    // Curto-circuito: FALSE em qualquer entrada define a saida
+    while (++k<N && !D::absorveE(result)) D::e(result, entrada(k));
+    break;
+  case TipoPorta::OR:
+  case TipoPorta::NO:
+    // Curto-circuito: TRUE em qualquer entrada define a saida
+    while (++k<N && !D::absorveOu(result)) D::ou(result, entrada(k));
+    break;
+  case TipoPorta::XO:
+  case TipoPorta::NX:
+    // Curto-circuito: UNDEF em qualquer entrada define a saida
+    while (++k<N && !D::absorveXou(result)) D::xou(result, entrada(k));
+    break;
+  }
+  // As portas negadas invertem o resultado da porta direta
+  if (tipo==TipoPorta::NT || tipo==TipoPorta::NA ||
+      tipo==TipoPorta::NO || tipo==TipoPorta::NX) result = D::nao(result);
+  return result;
+}
+
+// Avalia uma porta com N entradas armazenadas de forma contigua em in[0] ... in[N-1]
+template <class T>
+inline T avaliarPorta(TipoPorta tipo, const T* in, int N)
+{
+  return avaliarPorta<T>(tipo, N, [in](int k) -> const T& { return in[k]; });
+}
+
+// Avalia uma porta com N entradas armazenadas de forma indireta
+// em V[orig[0]] ... V[orig[N-1]]
+template <class T>
+inline T avaliarPorta(TipoPorta tipo, const T* V, const int* orig, int N)
+{
+  return avaliarPorta<T>(tipo, N, [V, orig](int k) -> const T& { return V[orig[k]]; });
+}
 
 ///
 /// A CLASSE ABSTRATA PORTA
@@ -12,9 +89,15 @@
 class Porta;
 using ptr_Porta = Porta*;
 
+// A classe Porta eh a interface usada para editar e salvar os circuitos.
+// O tipo da porta eh armazenado como um dado (TipoPorta) da propria classe base,
+// de modo que consultar o nome ou simular a porta nao exige chamadas virtuais.
+// As classes derivadas apenas fixam o tipo e validam o numero de entradas.
 class Porta
 {
 protected:
+    // O tipo da porta
+    TipoPorta tipo_port;
     // O numero de entradas da porta
     int Nin_port;
     // O valor logico da saida da porta (?, F ou T)
@@ -27,8 +110,8 @@ public:
 
     // A classe abstrata Porta nao tem construtor default.
     Porta() = delete;
-    // Construtor especifico (recebe como parametro o numero de entradas da porta)
-    Porta(int NI): Nin_port(NI),out_port(bool3S::UNDEF) {}
+    // Construtor especifico (recebe como parametro o tipo e o numero de entradas da porta)
+    Porta(TipoPorta T, int NI): tipo_port(T),Nin_port(NI),out_port(bool3S::UNDEF) {}
     // Destrutor virtual
     virtual ~Porta() {}
 
@@ -50,8 +133,17 @@ public:
     /// Funcoes de consulta
     /// ***********************
 
-    // Funcao virtual pura que retorna a sigla correta da Port (AN, NT, OR, NX, etc.)
-    virtual std::string getName() const = 0;
+    // Retorna a sigla correta da Porta (AN, NT, OR, NX, etc.)
+    std::string getName() const
+    {
+        return nomePorta(tipo_port);
+    }
+
+    // Retorna o tipo da porta (TipoPorta::AN, TipoPorta::NT, etc.)
+    TipoPorta getTipo() const
+    {
+        return tipo_port;
+    }
 
     // Retorna o numero de entradas da porta
     int getNumInputs() const
@@ -85,7 +177,15 @@ public:
     // Se a dimensao do vetor in_port for adequada (>0 e igual ao numero de entradas
     // da porta), armazena o resultado da simulacao em out_port e retorna true.
     // Se nao for, faz out_port = UNDEF e retorna false.
-    virtual bool simular(const std::vector<bool3S>& in_port) = 0;
+    bool simular(const std::vector<bool3S>& in_port)
+    {
+        return simular(in_port.data(), int(in_port.size()));
+    }
+
+    // Simula a porta com os N valores das entradas armazenados em in_port[0] ... in_port[N-1].
+    // Mesmo comportamento da versao com vector, mas permite passar qualquer trecho de
+    // memoria contigua (por exemplo, parte de um vetor reaproveitado), sem alocacoes.
+    bool simular(const bool3S* in_port, int N);
 };
 
 ///
@@ -96,11 +196,9 @@ class PortaNOT: public Porta
 {
 public:
     // Construtor default (fixa o numero de entradas da porta como sendo 1)
-    PortaNOT(): Porta(1) {}
+    PortaNOT(): Porta(TipoPorta::NT,1) {}
     // DEMAIS FUNCOES DA PORTA
     ptr_Porta clone() const override;
-    std::string getName() const override;
-    bool simular(const std::vector<bool3S>& in_port) override;
 };
 
 class PortaAND: public Porta
@@ -110,14 +208,12 @@ public:
     PortaAND() = delete;
     // Construtor especifico (recebe como parametro o numero de entradas da porta)
     // Se o parametro for invalido, faz Nin_port=0
-    PortaAND(int NI): Porta(NI)
+    PortaAND(int NI): Porta(TipoPorta::AN,NI)
     {
         if (NI<2) Nin_port=0;
     }
     // DEMAIS FUNCOES DA PORTA
     ptr_Porta clone() const override;
-    std::string getName() const override;
-    bool simular(const std::vector<bool3S>& in_port) override;
 };
 
 class PortaNAND: public Porta
@@ -127,14 +223,12 @@ public:
     PortaNAND() = delete;
     // Construtor especifico (recebe como parametro o numero de entradas da porta)
     // Se o parametro for invalido, faz Nin_port=0
-    PortaNAND(int NI): Porta(NI)
+    PortaNAND(int NI): Porta(TipoPorta::NA,NI)
     {
         if (NI<2) Nin_port=0;
     }
     // DEMAIS FUNCOES DA PORTA
     ptr_Porta clone() const override;
-    std::string getName() const override;
-    bool simular(const std::vector<bool3S>& in_port) override;
 };
 
 class PortaOR: public Porta
@@ -144,14 +238,12 @@ public:
     PortaOR() = delete;
     // Construtor especifico (recebe como parametro o numero de entradas da porta)
     // Se o parametro for invalido, faz Nin_port=0
-    PortaOR(int NI): Porta(NI)
+    PortaOR(int NI): Porta(TipoPorta::OR,NI)
     {
         if (NI<2) Nin_port=0;
     }
     // DEMAIS FUNCOES DA PORTA
     ptr_Porta clone() const override;
-    std::string getName() const override;
-    bool simular(const std::vector<bool3S>&) override;
 };
 
 class PortaNOR: public Porta
@@ -161,14 +253,12 @@ public:
     PortaNOR() = delete;
     // Construtor especifico (recebe como parametro o numero de entradas da porta)
     // Se o parametro for invalido, faz Nin_port=0
-    PortaNOR(int NI): Porta(NI)
+    PortaNOR(int NI): Porta(TipoPorta::NO,NI)
     {
         if (NI<2) Nin_port=0;
     }
     // DEMAIS FUNCOES DA PORTA
     ptr_Porta clone() const override;
-    std::string getName() const override;
-    bool simular(const std::vector<bool3S>& in_port) override;
 };
 
 class PortaXOR: public Porta
@@ -178,14 +268,12 @@ public:
     PortaXOR() = delete;
     // Construtor especifico (recebe como parametro o numero de entradas da porta)
     // Se o parametro for invalido, faz Nin_port=0
-    PortaXOR(int NI): Porta(NI)
+    PortaXOR(int NI): Porta(TipoPorta::XO,NI)
     {
         if (NI<2) Nin_port=0;
     }
     // DEMAIS FUNCOES DA PORTA
     ptr_Porta clone() const override;
-    std::string getName() const override;
-    bool simular(const std::vector<bool3S>& in_port) override;
 };
 
 class PortaNXOR: public Porta
@@ -195,14 +283,12 @@ public:
     PortaNXOR() = delete;
     // Construtor especifico (recebe como parametro o numero de entradas da porta)
     // Se o parametro for invalido, faz Nin_port=0
-    PortaNXOR(int NI): Porta(NI)
+    PortaNXOR(int NI): Porta(TipoPorta::NX,NI)
     {
         if (NI<2) Nin_port=0;
     }
     // DEMAIS FUNCOES DA PORTA
     ptr_Porta clone() const override;
-    std::string getName() const override;
-    bool simular(const std::vector<bool3S>& in_port) override;
 };
 
 #endif // _PORTA_H_
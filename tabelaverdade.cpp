@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <climits>
+#include "tabelaverdade.h"
+
+// Numero de linhas da tabela verdade de um circuito com N entradas
+long long numLinhasTabela(int N)
+{
+  if (N<0 || N>MAX_ENTRADAS_TABELA) return -1;
+  long long L = 1;
+  for (int i=0; i<N; ++i) L *= 3;
+  return L;
+}
+
+// Preenche in com a combinacao de entradas da linha "linha"
+void linhaParaEntradas(long long linha, std::vector<bool3S>& in)
+{
+  for (int i=int(in.size())-1; i>=0; --i)
+  {
+    in[i] = bool3S(linha%3);
+    linha /= 3;
+  }
+}
+
+// Passa para a combinacao de entradas da linha seguinte
+bool proximaLinha(std::vector<bool3S>& in)
+{
+  // Incrementa a ultima entrada que nao for TRUE
+  // Se a ultima for TRUE, tenta incrementar a anterior
+  int i = int(in.size())-1;
+  while (i>=0 && in[i]==bool3S::TRUE)
+  {
+    ++in[i];
+    --i;
+  }
+  // Incrementa a entrada selecionada
+  if (i>=0) ++in[i];
+  return (i>=0);
+}
+
+// Numero de linhas da tabela verdade binaria de um circuito com N entradas
+long long numLinhasTabelaBinaria(int N)
+{
+  if (N<0 || N>MAX_ENTRADAS_BINARIA) return -1;
+  return 1LL << N;
+}
+
+// Preenche in com as combinacoes de entradas de 64 linhas binarias consecutivas
+void linhasBinariasParaEntradas(long long primeira, std::vector<uint64_t>& in)
+{
+  // Padrao de cada um dos 6 bits menos significativos do numero da linha nas 64 linhas
+  static const uint64_t padrao[6] =
+  {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+  };
+  int N = int(in.size());
+  for (int j=0; j<N; ++j)
+  {
+    // Posicao do bit da entrada j no numero da linha
+    int b = N-1-j;
+    if (b < 6) in[j] = padrao[b];
+    else if (b < 63) in[j] = (((primeira >> b) & 1) ? ~0ULL : 0ULL);
+    else in[j] = 0;
+  }
+}
+
+///
+/// GERACAO PARALELA
+///
+
+// Gera todas as linhas da tabela verdade com as threads do pool
+bool gerarTabelaParalela(const CircuitoCompilado& C, PoolTrabalho& P, const ReceptorBloco& receptor)
+{
+  const int NI = C.getNumInputs();
+  const int NO = C.getNumOutputs();
+  const long long total = numLinhasTabela(NI);
+  if (total<0) return false;
+
+  // Cada rodada executa algumas tarefas por thread. Ha dois buffers de saidas: enquanto
+  // as threads do pool preenchem um com a rodada seguinte, o receptor recebe o outro
+  const int tarefasRodada = 4*P.getNumThreads();
+  const long long linhasRodada = (long long)tarefasRodada*LINHAS_TAREFA;
+  std::vector<bool3S> saidas[2];
+  saidas[0].resize(size_t(linhasRodada)*NO);
+  saidas[1].resize(size_t(linhasRodada)*NO);
+
+  // Vetores privados de cada thread (inclusive da que chama, que tambem executa
+  // tarefas em PoolTrabalho::aguardar): entradas e valores dos sinais
+  const int Nthreads = P.getNumThreads()+1;
+  std::vector< std::vector<bool3S> > in(Nthreads, std::vector<bool3S>(NI));
+  std::vector< std::vector<bool3S_64> > in64(Nthreads, std::vector<bool3S_64>(NI));
+  std::vector< std::vector<bool3S_64> > V(Nthreads, std::vector<bool3S_64>(C.getNumSinais()));
+
+  // A rodada em execucao: primeira linha, numero de linhas e buffer das saidas
+  long long base = 0;
+  long long Nlinhas = 0;
+  bool3S* buffer = nullptr;
+
+  // Cada tarefa simula LINHAS_TAREFA linhas, 64 por vez (uma em cada posicao do bool3S_64)
+  PoolTrabalho::Tarefa simularTarefa = [&](int tarefa, int thread)
+  {
+    long long primeira = base + (long long)tarefa*LINHAS_TAREFA;
+    int linhasTarefa = int(std::min((long long)LINHAS_TAREFA, base+Nlinhas-primeira));
+    std::vector<bool3S>& entradas = in[thread];
+    bool3S_64* entradas64 = in64[thread].data();
+    bool3S_64* valores = V[thread].data();
+    bool3S* dest = buffer + (primeira-base)*NO;
+
+    linhaParaEntradas(primeira, entradas);
+    for (int l0=0; l0<linhasTarefa; l0+=64)
+    {
+      // As (ateh) 64 linhas seguintes, uma em cada posicao das entradas
+      int N64 = std::min(64, linhasTarefa-l0);
+      for (int i=0; i<NI; ++i) entradas64[i] = bool3S_64{0, 0};
+      for (int l=0; l<N64; ++l)
+      {
+        for (int i=0; i<NI; ++i)
+        {
+          entradas64[i].t |= uint64_t(entradas[i]==bool3S::TRUE) << l;
+          entradas64[i].f |= uint64_t(entradas[i]==bool3S::FALSE) << l;
+        }
+        proximaLinha(entradas);
+      }
+
+      C.simular(entradas64, valores);
+      for (int l=0; l<N64; ++l)
+      {
+        for (int j=0; j<NO; ++j) *dest++ = getBool3S(C.getOutputCirc64(j, valores), l);
+      }
+    }
+  };
+
+  // Inicia uma rodada, a partir da linha "primeira", no buffer k
+  auto iniciarRodada = [&](long long primeira, int k)
+  {
+    base = primeira;
+    Nlinhas = std::min(total-primeira, linhasRodada);
+    buffer = saidas[k].data();
+    P.iniciar(int((Nlinhas+LINHAS_TAREFA-1)/LINHAS_TAREFA), simularTarefa);
+  };
+
+  iniciarRodada(0, 0);
+  for (int k=0; ; k=1-k)
+  {
+    P.aguardar();
+    long long primeira = base;
+    int linhas = int(Nlinhas);
+
+    // Inicia a rodada seguinte no outro buffer antes de entregar esta ao receptor
+    bool ultima = (primeira+linhas>=total);
+    if (!ultima) iniciarRodada(primeira+linhas, 1-k);
+    if (!receptor(primeira, linhas, saidas[k].data()))
+    {
+      if (!ultima) P.aguardar();
+      return false;
+    }
+    if (ultima) return true;
+  }
+}
+
+///
+/// CLASSE GERADOR GRAY
+///
+
+// Cria o gerador para N entradas, posicionado na primeira combinacao (todas UNDEF)
+GeradorGray::GeradorGray(int N):
+  in(N, bool3S::UNDEF),
+  sentido(N, +1),
+  peso(N),
+  linha(0),
+  mudou(-1)
+{
+  // Com N>MAX_ENTRADAS_TABELA os pesos nao cabem em um long long: os das primeiras
+  // entradas ficam 0 (e os numeros das linhas deixam de ter sentido)
+  long long p = 1;
+  for (int i=N-1; i>=0; --i)
+  {
+    peso[i] = p;
+    p = (p <= LLONG_MAX/3 ? 3*p : 0);
+  }
+}
+
+// Passa para a proxima combinacao (codigo de Gray ternario refletido).
+// Tenta mover a ultima entrada no seu sentido atual; se ela jah estiver no extremo,
+// inverte o seu sentido e tenta a entrada anterior, e assim por diante.
+bool GeradorGray::proximo()
+{
+  int i = int(in.size())-1;
+  while (i>=0)
+  {
+    // Valor da entrada i como digito (UNDEF=0, FALSE=1, TRUE=2) apos o movimento
+    int digito = int(in[i]) + sentido[i];
+    if (digito>=0 && digito<=2)
+    {
+      if (sentido[i]>0) ++in[i];
+      else --in[i];
+      linha += sentido[i]*peso[i];
+      mudou = i;
+      return true;
+    }
+    sentido[i] = -sentido[i];
+    --i;
+  }
+  return false;
+}
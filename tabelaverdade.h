@@ -0,0 +1,137 @@
+#ifndef _TABELAVERDADE_H_
+#define _TABELAVERDADE_H_
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "bool3S.h"
+#include "circuitocompilado.h"
+#include "pooltrabalho.h"
+
+/// ###########################################################################
+/// GERACAO DAS COMBINACOES DE ENTRADA DA TABELA VERDADE
+///
+/// Ordem canonica das linhas da tabela verdade: as N entradas formam um numero
+/// na base 3 (UNDEF=0, FALSE=1, TRUE=2), com a primeira entrada como digito mais
+/// significativo. A linha 0 tem todas as entradas UNDEF e a linha 3^N-1, todas TRUE.
+/// ###########################################################################
+
+// Maior numero de entradas da tabela verdade: 3^N e os numeros das linhas tem que
+// caber em um long long (3^39 < 2^63 < 3^40)
+constexpr int MAX_ENTRADAS_TABELA = 39;
+
+// Numero de linhas da tabela verdade de um circuito com N entradas (3^N),
+// ou -1 se N>MAX_ENTRADAS_TABELA
+long long numLinhasTabela(int N);
+
+// Preenche in (vetor com N valores) com a combinacao de entradas da linha "linha"
+void linhaParaEntradas(long long linha, std::vector<bool3S>& in);
+
+// Passa para a combinacao de entradas da linha seguinte na ordem canonica
+// (incrementa a ultima entrada que nao for TRUE, zerando as seguintes).
+// Retorna false se jah estava na ultima linha (e volta para a linha 0).
+bool proximaLinha(std::vector<bool3S>& in);
+
+// As mesmas funcoes para a tabela verdade binaria (entradas apenas FALSE e TRUE):
+// as N entradas formam um numero na base 2 (FALSE=0, TRUE=1), com a primeira entrada
+// como digito mais significativo.
+
+// Maior numero de entradas da tabela verdade binaria: 2^N e os numeros das linhas
+// tem que caber em um long long
+constexpr int MAX_ENTRADAS_BINARIA = 62;
+
+// Numero de linhas da tabela verdade binaria de um circuito com N entradas (2^N),
+// ou -1 se N>MAX_ENTRADAS_BINARIA
+long long numLinhasTabelaBinaria(int N);
+
+// Preenche in (vetor com N palavras) com as combinacoes de entradas das 64 linhas binarias
+// primeira, primeira+1, ..., primeira+63 (primeira deve ser multiplo de 64), no formato da
+// simulacao binaria: o bit k de in[j] eh o valor da entrada j na linha primeira+k.
+void linhasBinariasParaEntradas(long long primeira, std::vector<uint64_t>& in);
+
+///
+/// GERACAO PARALELA
+///
+
+// Funcao que recebe um bloco de linhas consecutivas da tabela verdade:
+// a primeira linha do bloco (na ordem canonica), o numero de linhas e as saidas
+// do circuito (Nlinhas*NO valores, linha a linha).
+// Se retornar false, a geracao eh interrompida.
+using ReceptorBloco = std::function<bool(long long primeira, int Nlinhas, const bool3S* saidas)>;
+
+// Numero de linhas que cada tarefa da geracao paralela simula
+constexpr int LINHAS_TAREFA = 1024;
+
+// Gera todas as linhas da tabela verdade do circuito C com as threads do pool P.
+// O circuito deve ter no maximo MAX_ENTRADAS_TABELA entradas.
+// As linhas sao divididas em tarefas de LINHAS_TAREFA linhas, executadas com roubo de
+// trabalho; cada thread simula 64 linhas por vez (simular com bool3S_64), com o seu
+// proprio vetor de valores dos sinais.
+// As tarefas sao executadas em rodadas com dois buffers: enquanto o receptor recebe
+// uma rodada, o pool jah simula a seguinte (e a thread que chamou esta funcao, depois
+// de entregar a rodada, ajuda a simular).
+// O receptor eh sempre chamado pela thread que chamou esta funcao, com os blocos
+// em ordem crescente de linha: o resultado eh identico ao da geracao sequencial.
+// A memoria usada eh limitada (algumas tarefas por thread), qualquer que seja 3^N.
+// Retorna false se o circuito tiver entradas demais ou se a geracao foi interrompida
+// pelo receptor.
+bool gerarTabelaParalela(const CircuitoCompilado& C, PoolTrabalho& P, const ReceptorBloco& receptor);
+
+///
+/// CLASSE GERADOR GRAY
+///
+/// Enumera as 3^N combinacoes de N entradas bool3S em codigo de Gray ternario refletido:
+/// cada combinacao difere da anterior em exatamente uma entrada (que muda para o valor
+/// vizinho: UNDEF<->FALSE ou FALSE<->TRUE). Assim, a simulacao de cada nova combinacao
+/// soh precisa propagar a mudanca de uma entrada (Circuito::simularEventos).
+/// Para cada combinacao, informa tambem a linha correspondente na ordem canonica
+/// (que soh tem sentido com N<=MAX_ENTRADAS_TABELA).
+///
+/// Uso tipico:
+///   GeradorGray G(N);
+///   do { ... G.getEntradas() ... G.getLinha() ... } while (G.proximo());
+///
+
+class GeradorGray
+{
+private:
+  // Combinacao atual das entradas
+  std::vector<bool3S> in;
+  // Sentido em que cada entrada estah sendo percorrida (+1 ou -1)
+  std::vector<int> sentido;
+  // Peso de cada entrada na ordem canonica (3^(N-1-i))
+  std::vector<long long> peso;
+  // Linha da combinacao atual na ordem canonica
+  long long linha;
+  // Indice da entrada que mudou na ultima chamada de proximo (-1 na combinacao inicial)
+  int mudou;
+
+public:
+  // Cria o gerador para N entradas, posicionado na primeira combinacao (todas UNDEF)
+  explicit GeradorGray(int N);
+
+  // Passa para a proxima combinacao.
+  // Retorna false se todas as combinacoes jah foram geradas (a combinacao atual nao muda).
+  bool proximo();
+
+  // Combinacao atual das entradas
+  const std::vector<bool3S>& getEntradas() const
+  {
+    return in;
+  }
+
+  // Linha (de 0 a 3^N-1) da combinacao atual na ordem canonica
+  long long getLinha() const
+  {
+    return linha;
+  }
+
+  // Indice (de 0 a N-1) da entrada que mudou na ultima chamada de proximo
+  // ou -1 se ainda estah na combinacao inicial
+  int getMudou() const
+  {
+    return mudou;
+  }
+};
+
+#endif // _TABELAVERDADE_H_
@@ -0,0 +1,1928 @@
+// Testes automaticos do simulador (nao faz parte do aplicativo Qt).
+//
+// Compara as simulacoes com uma simulacao de referencia (iteracao de ponto fixo
+// escalar, a partir de todos os sinais UNDEF) em circuitos aleatorios com e sem lacos,
+// um vetor de entradas por vez ou varios vetores simultaneos.
+//
+// Compilacao: qmake Testes.pro && make
+// ou (exemplo com g++):
+// g++ -std=c++17 -O2 -o teste3 teste3.cpp circuito.cpp circuitocompilado.cpp
+//     kernelsimd.cpp tabelaverdade.cpp pooltrabalho.cpp porta.cpp arenaportas.cpp bool3S.cpp
+//     otimizar.cpp arquivomapeado.cpp importar.cpp exportartabela.cpp -pthread
+//
+// Uso: teste3
+// Retorna 0 se todos os testes passarem e 1 se algum falhar.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+#include <atomic>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#include "circuito.h"
+#include "arenaportas.h"
+#include "kernelsimd.h"
+#include "tabelaverdade.h"
+#include "pooltrabalho.h"
+#include "otimizar.h"
+#include "leitortexto.h"
+#include "importar.h"
+#include "exportartabela.h"
+
+using namespace std;
+
+/// ***********************
+/// Contagem de alocacoes de memoria
+/// ***********************
+
+// Os operadores new e delete globais sao substituidos por versoes que contam as alocacoes
+// (de todas as threads)
+static atomic<long long> Nalocacoes(0);
+
+void* operator new(size_t N)
+{
+  ++Nalocacoes;
+  if (void* p = malloc(N>0 ? N : 1)) return p;
+  throw bad_alloc();
+}
+void* operator new(size_t N, align_val_t A)
+{
+  ++Nalocacoes;
+  size_t alin = size_t(A);
+  if (void* p = aligned_alloc(alin, (N+alin-1)/alin*alin)) return p;
+  throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, align_val_t) noexcept { free(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { free(p); }
+
+/// ***********************
+/// Funcoes auxiliares
+/// ***********************
+
+// Numero de testes que falharam
+static int falhas = 0;
+
+// Registra uma falha se a condicao for falsa
+static void verificar(bool condicao, const string& msg)
+{
+  if (!condicao)
+  {
+    ++falhas;
+    cout << "  FALHA: " << msg << endl;
+  }
+}
+
+// Os tipos de porta, com os nomes usados por setPort
+static const char* const TIPOS[] = {"NT", "AN", "NA", "OR", "NO", "XO", "NX"};
+
+// Um circuito na forma mais simples possivel, para a simulacao de referencia:
+// o tipo e as ids das origens das entradas de cada porta e as ids das origens das saidas
+struct Descricao
+{
+  int NI = 0;
+  vector<string> tipo;
+  vector< vector<int> > entradas;
+  vector<int> saidas;
+};
+
+// Gera um circuito aleatorio com NI entradas, NO saidas e NP portas.
+// Sem lacos, cada porta soh usa as entradas e as portas anteriores.
+// Algumas portas repetem (em outra ordem) as entradas de uma porta anterior do mesmo
+// tipo, como acontece nos circuitos reais.
+static Descricao circuitoAleatorio(mt19937& G, int NI, int NO, int NP, bool comLacos)
+{
+  Descricao D;
+  D.NI = NI;
+  for (int p=0; p<NP; ++p)
+  {
+    if (p>0 && G()%5==0)
+    {
+      int q = int(G()%p);
+      D.tipo.push_back(D.tipo[q]);
+      D.entradas.push_back(D.entradas[q]);
+      shuffle(D.entradas.back().begin(), D.entradas.back().end(), G);
+      continue;
+    }
+    string tipo = TIPOS[G()%7];
+    int Nin = (tipo=="NT" ? 1 : 2+int(G()%3));
+    int Norig = NI + (comLacos ? NP : p);
+    vector<int> in;
+    for (int k=0; k<Nin; ++k)
+    {
+      int r = int(G()%Norig);
+      in.push_back(r<NI ? -(r+1) : r-NI+1);
+    }
+    D.tipo.push_back(tipo);
+    D.entradas.push_back(in);
+  }
+  for (int j=0; j<NO; ++j)
+  {
+    int r = int(G()%(NI+NP));
+    D.saidas.push_back(r<NI ? -(r+1) : r-NI+1);
+  }
+  return D;
+}
+
+// Monta o Circuito correspondente a uma descricao
+static Circuito construir(const Descricao& D)
+{
+  const int NP = int(D.tipo.size()), NO = int(D.saidas.size());
+  Circuito C(D.NI, NO, NP);
+  bool ok = true;
+  for (int p=0; p<NP; ++p)
+  {
+    string tipo = D.tipo[p];
+    ok = ok && C.setPort(p+1, tipo, int(D.entradas[p].size()));
+    for (size_t k=0; k<D.entradas[p].size(); ++k)
+    {
+      ok = ok && C.setIdInPort(p+1, int(k), D.entradas[p][k]);
+    }
+  }
+  for (int j=0; j<NO; ++j) ok = ok && C.setIdOutputCirc(j+1, D.saidas[j]);
+  verificar(ok && C.valid(), "construir");
+  return C;
+}
+
+// Avalia uma porta, de forma direta, a partir dos valores das suas entradas
+static bool3S avaliarReferencia(const string& tipo, const vector<bool3S>& x)
+{
+  if (tipo=="NT") return ~x[0];
+  bool3S r = x[0];
+  for (size_t k=1; k<x.size(); ++k)
+  {
+    if (tipo=="AN" || tipo=="NA") r = r & x[k];
+    else if (tipo=="OR" || tipo=="NO") r = r | x[k];
+    else r = r ^ x[k];
+  }
+  if (tipo=="NA" || tipo=="NO" || tipo=="NX") r = ~r;
+  return r;
+}
+
+// Simulacao de referencia: todos os sinais comecam UNDEF e todas as portas sao
+// reavaliadas ateh que nenhuma mude (o ponto fixo que todas as simulacoes devem produzir)
+static vector<bool3S> simularReferencia(const Descricao& D, const vector<bool3S>& in)
+{
+  const int NP = int(D.tipo.size());
+  vector<bool3S> valor(NP, bool3S::UNDEF);
+  auto origem = [&](int id) { return (id>0 ? valor[id-1] : in[-id-1]); };
+  bool mudou = true;
+  while (mudou)
+  {
+    mudou = false;
+    for (int p=0; p<NP; ++p)
+    {
+      vector<bool3S> x;
+      for (int id : D.entradas[p]) x.push_back(origem(id));
+      bool3S r = avaliarReferencia(D.tipo[p], x);
+      if (r!=valor[p])
+      {
+        valor[p] = r;
+        mudou = true;
+      }
+    }
+  }
+  vector<bool3S> out;
+  for (int id : D.saidas) out.push_back(origem(id));
+  return out;
+}
+
+// Vetor de NI entradas aleatorias
+static vector<bool3S> entradasAleatorias(mt19937& G, int NI)
+{
+  vector<bool3S> in(NI);
+  for (auto& x : in) x = bool3S(G()%3);
+  return in;
+}
+
+// As entradas da linha "linha" da tabela verdade (ordem canonica)
+static vector<bool3S> entradasDaLinha(long long linha, int NI)
+{
+  vector<bool3S> in(NI);
+  linhaParaEntradas(linha, in);
+  return in;
+}
+
+// Todas as saidas do Circuito apos uma simulacao
+static vector<bool3S> saidasCircuito(const Circuito& C)
+{
+  vector<bool3S> out;
+  for (int j=1; j<=C.getNumOutputs(); ++j) out.push_back(C.getOutputCirc(j));
+  return out;
+}
+
+// Retorna true se a descricao tem algum laco (busca em profundidade a partir de cada porta)
+static bool temLaco(const Descricao& D)
+{
+  const int NP = int(D.tipo.size());
+  vector<int> estado(NP, 0);   // 0: nao visitada, 1: na pilha, 2: concluida
+  bool laco = false;
+  auto visitar = [&](auto& self, int p) -> void
+  {
+    estado[p] = 1;
+    for (int id : D.entradas[p])
+    {
+      if (id<0) continue;
+      if (estado[id-1]==1) laco = true;
+      else if (estado[id-1]==0) self(self, id-1);
+    }
+    estado[p] = 2;
+  };
+  for (int p=0; p<NP; ++p) if (estado[p]==0) visitar(visitar, p);
+  return laco;
+}
+
+// Grava um arquivo com o conteudo "texto"
+static void gravarArquivo(const string& arq, const string& texto)
+{
+  ofstream F(arq, ios::binary);
+  F << texto;
+}
+
+// Le o conteudo de um arquivo
+static string lerArquivo(const string& arq)
+{
+  ifstream F(arq, ios::binary);
+  ostringstream S;
+  S << F.rdbuf();
+  return S.str();
+}
+
+// Posicao (no arquivo binario B) do elemento j da secao k: o cabecalho guarda a posicao
+// de cada secao a partir do byte 64, na ordem de CircuitoCompilado::salvarBinario
+static size_t posicaoBinario(const string& B, int k, int j)
+{
+  uint64_t secao;
+  memcpy(&secao, B.data()+64+8*k, sizeof(secao));
+  return size_t(secao)+sizeof(int)*j;
+}
+
+// Elemento j (int) da secao k do arquivo binario B
+static int elementoBinario(const string& B, int k, int j)
+{
+  int v;
+  memcpy(&v, B.data()+posicaoBinario(B, k, j), sizeof(v));
+  return v;
+}
+
+// Altera o elemento j (int) da secao k do arquivo binario B e recalcula a soma de
+// verificacao (o mesmo calculo de circuitocompilado.cpp), para que o arquivo soh
+// possa ser rejeitado pela conferencia da estrutura
+static void alterarBinario(string& B, int k, int j, int v)
+{
+  memcpy(&B[posicaoBinario(B, k, j)], &v, sizeof(v));
+
+  const size_t POS_VERIFICACAO = 56;
+  memset(&B[POS_VERIFICACAO], 0, sizeof(uint64_t));
+  uint64_t h[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL,
+                   0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+  uint64_t w[4];
+  for (size_t p=0; p<B.size(); p+=sizeof(w))
+  {
+    memcpy(w, B.data()+p, sizeof(w));
+    for (int i=0; i<4; ++i) h[i] = ((h[i]^w[i])*0x9E3779B97F4A7C15ULL) ^ (h[i]>>29);
+  }
+  uint64_t soma = 0;
+  for (int i=0; i<4; ++i) soma = (soma ^ h[i]) * 0xBF58476D1CE4E5B9ULL + uint64_t(i);
+  soma ^= soma>>31;
+  memcpy(&B[POS_VERIFICACAO], &soma, sizeof(soma));
+}
+
+// Retorna true se o arquivo existe
+static bool existeArquivo(const string& arq)
+{
+  ifstream F(arq);
+  return F.is_open();
+}
+
+// Compara toda a tabela verdade de C com a simulacao de referencia de D
+static bool tabelaIgualReferencia(Circuito& C, const Descricao& D)
+{
+  bool iguais = true;
+  C.gerarTabela([&](long long linha, const bool3S* in, const bool3S* out)
+  {
+    vector<bool3S> esperado = simularReferencia(D, vector<bool3S>(in, in+D.NI));
+    iguais = iguais && (linha>=0) && equal(esperado.begin(), esperado.end(), out);
+    return iguais;
+  });
+  return iguais;
+}
+
+/// ***********************
+/// Simulacao
+/// ***********************
+
+// simular comparada com a referencia, inclusive apos alterar o circuito
+static void testarSimulacao(mt19937& G)
+{
+  cout << "Simulacao" << endl;
+  for (int caso=0; caso<60; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NO = 1+int(G()%5), NP = 1+int(G()%40);
+    Descricao D = circuitoAleatorio(G, NI, NO, NP, comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    verificar(C.possuiCiclo()==temLaco(D), "possuiCiclo: " + nome);
+    for (int k=0; k<20; ++k)
+    {
+      vector<bool3S> in = entradasAleatorias(G, NI);
+      verificar(C.simular(in) && saidasCircuito(C)==simularReferencia(D, in), "simular: " + nome);
+    }
+
+    // Troca as origens de uma porta: a ordem de avaliacao tem que ser recalculada
+    const int p = int(G()%NP);
+    for (size_t k=0; k<D.entradas[p].size(); ++k)
+    {
+      int r = int(G()%(NI+NP));
+      D.entradas[p][k] = (r<NI ? -(r+1) : r-NI+1);
+      C.setIdInPort(p+1, int(k), D.entradas[p][k]);
+    }
+    verificar(C.possuiCiclo()==temLaco(D), "possuiCiclo apos alteracao: " + nome);
+    vector<bool3S> in = entradasAleatorias(G, NI);
+    verificar(C.simular(in) && saidasCircuito(C)==simularReferencia(D, in),
+              "simular apos alteracao: " + nome);
+
+    // Entradas em numero errado
+    verificar(!C.simular(vector<bool3S>(NI+1)), "simular com entradas demais: " + nome);
+  }
+}
+
+/// ***********************
+/// Representacao compilada
+/// ***********************
+
+// Os valores das portas, as copias e as alteracoes depois da compilacao
+static void testarCompilado(mt19937& G)
+{
+  cout << "Representacao compilada" << endl;
+  for (int caso=0; caso<40; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%6), NP = 1+int(G()%30);
+    Descricao D = circuitoAleatorio(G, NI, 1+int(G()%4), NP, comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    // O valor de cada porta: uma descricao com uma saida para cada porta
+    Descricao todas = D;
+    todas.saidas.clear();
+    for (int p=1; p<=NP; ++p) todas.saidas.push_back(p);
+    vector<bool3S> in = entradasAleatorias(G, NI);
+    vector<bool3S> esperado = simularReferencia(todas, in);
+    bool ok = C.simular(in);
+    for (int p=1; p<=NP && ok; ++p) ok = (C.getOutputPort(p)==esperado[p-1]);
+    verificar(ok, "getOutputPort: " + nome);
+
+    // A copia eh igual e independente do original
+    Circuito copia(C);
+    verificar(copia==C, "copia igual: " + nome);
+    Descricao D2 = D;
+    const int p = int(G()%NP);
+    D2.tipo[p] = (D2.tipo[p]=="NT" ? "NT" : (D2.tipo[p]=="AN" ? "OR" : "AN"));
+    string tipo = D2.tipo[p];
+    copia.setPort(p+1, tipo, int(D2.entradas[p].size()));
+    for (size_t k=0; k<D2.entradas[p].size(); ++k) copia.setIdInPort(p+1, int(k), D2.entradas[p][k]);
+    in = entradasAleatorias(G, NI);
+    verificar(copia.simular(in) && saidasCircuito(copia)==simularReferencia(D2, in) &&
+              C.simular(in) && saidasCircuito(C)==simularReferencia(D, in), "copia alterada: " + nome);
+
+    // Atribuicao e movimento
+    Circuito atribuido;
+    atribuido = C;
+    Circuito movido(std::move(copia));
+    verificar(atribuido==C && atribuido.simular(in) && saidasCircuito(atribuido)==simularReferencia(D, in) &&
+              movido.simular(in) && saidasCircuito(movido)==simularReferencia(D2, in),
+              "atribuicao e movimento: " + nome);
+  }
+}
+
+/// ***********************
+/// Simulacao bit-paralela
+/// ***********************
+
+// Os operadores de bool3S_64 e simular64 comparados com os valores escalares
+static void testarSimular64(mt19937& G)
+{
+  cout << "Simulacao bit-paralela" << endl;
+
+  // Todas as combinacoes de dois operandos, uma em cada posicao
+  bool3S_64 x = toBool3S_64(bool3S::UNDEF), y = x;
+  for (int k=0; k<9; ++k)
+  {
+    setBool3S(x, k, bool3S(k/3));
+    setBool3S(y, k, bool3S(k%3));
+  }
+  bool ok = true;
+  for (int k=0; k<9; ++k)
+  {
+    const bool3S a = bool3S(k/3), b = bool3S(k%3);
+    ok = ok && getBool3S(~x, k)==~a && getBool3S(x&y, k)==(a&b) &&
+         getBool3S(x|y, k)==(a|b) && getBool3S(x^y, k)==(a^b);
+  }
+  verificar(ok, "operadores de bool3S_64");
+
+  for (int caso=0; caso<40; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NO = 1+int(G()%5);
+    Descricao D = circuitoAleatorio(G, NI, NO, 1+int(G()%40), comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    // 64 vetores aleatorios simultaneos
+    vector< vector<bool3S> > vetores;
+    vector<bool3S_64> in64(NI, toBool3S_64(bool3S::UNDEF));
+    for (int l=0; l<64; ++l)
+    {
+      vetores.push_back(entradasAleatorias(G, NI));
+      for (int i=0; i<NI; ++i) setBool3S(in64[i], l, vetores[l][i]);
+    }
+    ok = C.simular64(in64);
+    for (int l=0; l<64 && ok; ++l)
+    {
+      vector<bool3S> esperado = simularReferencia(D, vetores[l]);
+      for (int j=0; j<NO; ++j) ok = ok && getBool3S(C.getOutputCirc64(j+1), l)==esperado[j];
+    }
+    verificar(ok, "simular64: " + nome);
+    verificar(!C.simular64(vector<bool3S_64>(NI+1)), "simular64 com entradas demais: " + nome);
+  }
+}
+
+/// ***********************
+/// Kernels vetoriais
+/// ***********************
+
+// Cada kernel disponivel comparado com a avaliacao escalar, porta a porta e no circuito
+static void testarKernels(mt19937& G)
+{
+  cout << "Kernels vetoriais (melhor: " << nomeSIMD(nivelSIMD()) << ")" << endl;
+  verificar(kernelPorta()!=nullptr && kernelPorta(NivelSIMD::ESCALAR)!=nullptr, "kernel disponivel");
+
+  // Uma porta de cada tipo e de 1 a 4 entradas, com o destino separado ou sobre a 1a entrada
+  for (NivelSIMD N : {NivelSIMD::ESCALAR, NivelSIMD::AVX2, NivelSIMD::AVX512})
+  {
+    KernelPorta K = kernelPorta(N);
+    if (K==nullptr) continue;
+    bool ok = true;
+    for (int t=0; t<7; ++t)
+    {
+      for (int n=1; n<=4; ++n)
+      {
+        if ((t==0) != (n==1)) continue;
+        vector<bool3S_bloco> V(n+1, toBool3S_bloco(bool3S::UNDEF));
+        for (int i=0; i<n; ++i)
+        {
+          for (int l=0; l<BOOL3S_BLOCO; ++l) setBool3S(V[i], l, bool3S(G()%3));
+        }
+        vector<int> orig(n);
+        for (int i=0; i<n; ++i) orig[i] = i;
+        vector<bool3S> esperado(BOOL3S_BLOCO);
+        for (int l=0; l<BOOL3S_BLOCO; ++l)
+        {
+          vector<bool3S> x;
+          for (int i=0; i<n; ++i) x.push_back(getBool3S(V[i], l));
+          esperado[l] = avaliarReferencia(TIPOS[t], x);
+        }
+        K(TipoPorta(t), orig.data(), n, V.data(), V[n]);
+        K(TipoPorta(t), orig.data(), n, V.data(), V[0]);
+        for (int l=0; l<BOOL3S_BLOCO; ++l)
+        {
+          ok = ok && getBool3S(V[n], l)==esperado[l] && getBool3S(V[0], l)==esperado[l];
+        }
+      }
+    }
+    verificar(ok, string("kernel ") + nomeSIMD(N));
+  }
+
+  // simularBloco com cada kernel disponivel
+  for (int caso=0; caso<30; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NO = 1+int(G()%5);
+    Descricao D = circuitoAleatorio(G, NI, NO, 1+int(G()%40), comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    vector< vector<bool3S> > esperados;
+    vector<bool3S_bloco> in(NI, toBool3S_bloco(bool3S::UNDEF));
+    for (int l=0; l<BOOL3S_BLOCO; ++l)
+    {
+      vector<bool3S> v = entradasAleatorias(G, NI);
+      for (int i=0; i<NI; ++i) setBool3S(in[i], l, v[i]);
+      esperados.push_back(simularReferencia(D, v));
+    }
+    for (NivelSIMD N : {NivelSIMD::ESCALAR, NivelSIMD::AVX2, NivelSIMD::AVX512})
+    {
+      KernelPorta K = kernelPorta(N);
+      if (K==nullptr) continue;
+      bool ok = C.simularBloco(in, K);
+      for (int l=0; l<BOOL3S_BLOCO && ok; ++l)
+      {
+        for (int j=0; j<NO; ++j) ok = ok && getBool3S(C.getOutputCircBloco(j+1), l)==esperados[l][j];
+      }
+      verificar(ok, string("simularBloco ") + nomeSIMD(N) + ": " + nome);
+    }
+  }
+}
+
+/// ***********************
+/// Simulacao por eventos
+/// ***********************
+
+// simularEventos com vetores que mudam pouco, intercalada com as outras simulacoes
+// e com alteracoes do circuito
+static void testarEventos(mt19937& G)
+{
+  cout << "Simulacao por eventos" << endl;
+  for (int caso=0; caso<40; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NO = 1+int(G()%5), NP = 1+int(G()%40);
+    Descricao D = circuitoAleatorio(G, NI, NO, NP, comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    vector<bool3S> in = entradasAleatorias(G, NI);
+    bool ok = true;
+    for (int k=0; k<60 && ok; ++k)
+    {
+      ok = C.simularEventos(in) && saidasCircuito(C)==simularReferencia(D, in);
+
+      // De vez em quando, outra simulacao ou uma alteracao entre dois eventos
+      if (k%10==5) C.simular64(vector<bool3S_64>(NI, toBool3S_64(bool3S(G()%3))));
+      if (k%10==7) C.simular(entradasAleatorias(G, NI));
+      if (k==30)
+      {
+        const int p = int(G()%NP), i = int(G()%D.entradas[p].size());
+        const int r = int(G()%(NI + (comLacos ? NP : p)));
+        D.entradas[p][i] = (r<NI ? -(r+1) : r-NI+1);
+        C.setIdInPort(p+1, i, D.entradas[p][i]);
+      }
+
+      in[G()%NI] = bool3S(G()%3);
+      if (G()%3==0) in[G()%NI] = bool3S(G()%3);
+    }
+    verificar(ok, "simularEventos: " + nome);
+    verificar(!C.simularEventos(vector<bool3S>(NI+1)), "simularEventos com entradas demais: " + nome);
+  }
+}
+
+/// ***********************
+/// Codigo de Gray ternario
+/// ***********************
+
+// Linha de uma combinacao de entradas na ordem canonica (base 3, primeira entrada
+// como digito mais significativo)
+static long long linhaCanonica(const vector<bool3S>& in)
+{
+  long long linha = 0;
+  for (bool3S x : in) linha = 3*linha + int(x);
+  return linha;
+}
+
+// GeradorGray percorre todas as combinacoes, mudando uma entrada por vez
+static void testarGray()
+{
+  cout << "Codigo de Gray ternario" << endl;
+  for (int N=0; N<=7; ++N)
+  {
+    long long total = 1;
+    for (int i=0; i<N; ++i) total *= 3;
+    vector<char> vista(size_t(total), 0);
+    GeradorGray gray(N);
+    vector<bool3S> anterior = gray.getEntradas();
+    long long Nlinhas = 0;
+    bool ok = (gray.getMudou()==-1);
+    do
+    {
+      const vector<bool3S>& in = gray.getEntradas();
+      const long long linha = gray.getLinha();
+      ok = ok && int(in.size())==N && linha==linhaCanonica(in) && !vista[linha];
+      if (!ok) break;
+      vista[linha] = 1;
+      ++Nlinhas;
+
+      // Exatamente a entrada informada mudou, para um valor vizinho
+      if (Nlinhas>1)
+      {
+        const int i = gray.getMudou();
+        ok = (i>=0 && i<N && abs(int(in[i])-int(anterior[i]))==1);
+        for (int k=0; k<N && ok; ++k) ok = (k==i || in[k]==anterior[k]);
+      }
+      anterior = in;
+    } while (ok && gray.proximo());
+    verificar(ok && Nlinhas==total, "GeradorGray N=" + to_string(N));
+  }
+
+  // Entradas demais para numerar as linhas: a enumeracao continua funcionando
+  // (nas 100 primeiras combinacoes, soh as 5 ultimas entradas mudam)
+  GeradorGray grande(45);
+  bool ok = true;
+  for (int k=0; k<100 && ok; ++k) ok = grande.proximo() && grande.getMudou()>=40;
+  verificar(ok, "GeradorGray com 45 entradas");
+}
+
+/// ***********************
+/// Geracao paralela
+/// ***********************
+
+// O pool de threads e a geracao paralela da tabela verdade
+static void testarParalela(mt19937& G)
+{
+  cout << "Geracao paralela" << endl;
+
+  // Ordem canonica e limites do numero de linhas: 3^39 cabe em um long long; 3^40 nao
+  bool ok = true;
+  vector<bool3S> in(5, bool3S::UNDEF);
+  for (long long l=0; l<numLinhasTabela(5) && ok; ++l)
+  {
+    ok = (in==entradasDaLinha(l, 5) && linhaCanonica(in)==l);
+    ok = ok && (proximaLinha(in) == (l+1<numLinhasTabela(5)));
+  }
+  verificar(ok && in==vector<bool3S>(5, bool3S::UNDEF), "linhaParaEntradas e proximaLinha");
+  verificar(numLinhasTabela(0)==1 && numLinhasTabela(MAX_ENTRADAS_TABELA)==4052555153018976267LL &&
+            numLinhasTabela(MAX_ENTRADAS_TABELA+1)<0 && numLinhasTabela(-1)<0, "numLinhasTabela");
+
+  // Cada tarefa eh executada uma unica vez, por uma thread valida, com executar
+  // e com iniciar/aguardar (em que a thread que chama tambem executa tarefas)
+  for (int Nthreads=1; Nthreads<=4; ++Nthreads)
+  {
+    PoolTrabalho P(Nthreads);
+    for (int Ntarefas : {0, 1, 7, 1000})
+    {
+      vector<int> vezes(Ntarefas, 0);
+      bool threadOK = true;
+      P.executar(Ntarefas, [&](int t, int thread)
+      {
+        ++vezes[t];
+        if (thread<0 || thread>=Nthreads) threadOK = false;
+      });
+      ok = threadOK && count(vezes.begin(), vezes.end(), 1)==Ntarefas;
+
+      vector<int> vezes2(Ntarefas, 0);
+      PoolTrabalho::Tarefa T = [&](int t, int thread)
+      {
+        ++vezes2[t];
+        if (thread<0 || thread>Nthreads) threadOK = false;
+      };
+      P.iniciar(Ntarefas, T);
+      P.aguardar();
+      ok = ok && threadOK && count(vezes2.begin(), vezes2.end(), 1)==Ntarefas;
+      verificar(ok, "PoolTrabalho com " + to_string(Nthreads) + " threads e " +
+                to_string(Ntarefas) + " tarefas");
+    }
+  }
+
+  // A tabela gerada em paralelo eh a da simulacao de referencia, em ordem
+  for (int caso=0; caso<30; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NO = 1+int(G()%4);
+    Descricao D = circuitoAleatorio(G, NI, NO, 1+int(G()%30), comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    PoolTrabalho P(1+caso%4);
+    long long proxima = 0;
+    ok = true;
+    bool gerou = gerarTabelaParalela(C.getCompilado(), P, [&](long long primeira, int Nlinhas, const bool3S* saidas)
+    {
+      ok = ok && primeira==proxima;
+      for (int l=0; l<Nlinhas && ok; ++l)
+      {
+        vector<bool3S> esperado = simularReferencia(D, entradasDaLinha(primeira+l, NI));
+        ok = equal(esperado.begin(), esperado.end(), saidas + size_t(l)*NO);
+      }
+      proxima = primeira+Nlinhas;
+      return ok;
+    });
+    verificar(gerou && ok && proxima==numLinhasTabela(NI), "gerarTabelaParalela: " + nome);
+  }
+}
+
+/// ***********************
+/// Tabela verdade
+/// ***********************
+
+// Um circuito com NI entradas e uma unica porta AND de todas elas
+static Circuito circuitoLargo(int NI)
+{
+  Descricao D;
+  D.NI = NI;
+  D.tipo.push_back("AN");
+  D.entradas.resize(1);
+  for (int i=0; i<NI; ++i) D.entradas[0].push_back(-(i+1));
+  D.saidas.push_back(1);
+  return construir(D);
+}
+
+// As formas de gerar a tabela verdade de um Circuito comparadas com a referencia
+static void testarTabela(mt19937& G)
+{
+  cout << "Tabela verdade" << endl;
+  PoolTrabalho P(3);
+  for (int caso=0; caso<30; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%6), NO = 1+int(G()%4), NP = 1+int(G()%30);
+    Descricao D = circuitoAleatorio(G, NI, NO, NP, comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+    const long long total = numLinhasTabela(NI);
+
+    // Ordem canonica (sequencial)
+    vector< vector<bool3S> > tabela;
+    bool ok = C.gerarTabela([&](long long linha, const bool3S* in, const bool3S* out)
+    {
+      bool linhaOK = (linha==(long long)tabela.size()) &&
+                     vector<bool3S>(in, in+NI)==entradasDaLinha(linha, NI);
+      tabela.emplace_back(out, out+NO);
+      return linhaOK;
+    });
+    ok = ok && (long long)tabela.size()==total;
+    for (long long l=0; l<total && ok; ++l) ok = (tabela[l]==simularReferencia(D, entradasDaLinha(l, NI)));
+    verificar(ok, "gerarTabela canonica: " + nome);
+
+    // Ordem de Gray: cada linha eh informada com o seu numero na ordem canonica
+    long long Nlinhas = 0;
+    vector<char> vista(size_t(total), 0);
+    ok = C.gerarTabela([&](long long linha, const bool3S* in, const bool3S* out)
+    {
+      ++Nlinhas;
+      if (linha<0 || linha>=total || vista[linha]) return false;
+      vista[linha] = 1;
+      return vector<bool3S>(in, in+NI)==entradasDaLinha(linha, NI) &&
+             vector<bool3S>(out, out+NO)==tabela[linha];
+    }, OrdemTabela::GRAY);
+    verificar(ok && Nlinhas==total, "gerarTabela Gray: " + nome);
+
+    // Paralela: identica aa sequencial
+    Nlinhas = 0;
+    ok = C.gerarTabela([&](long long linha, const bool3S* in, const bool3S* out)
+    {
+      return linha==Nlinhas++ && vector<bool3S>(in, in+NI)==entradasDaLinha(linha, NI) &&
+             vector<bool3S>(out, out+NO)==tabela[linha];
+    }, P);
+    verificar(ok && Nlinhas==total, "gerarTabela paralela: " + nome);
+
+    // Interrupcao pelo receptor, sequencial e paralela
+    Nlinhas = 0;
+    ok = C.gerarTabela([&](long long, const bool3S*, const bool3S*) { return ++Nlinhas<5; });
+    verificar(total<5 || (!ok && Nlinhas==5), "interrupcao da tabela: " + nome);
+    Nlinhas = 0;
+    ok = C.gerarTabela([&](long long, const bool3S*, const bool3S*) { return ++Nlinhas<5; }, P);
+    verificar(total<5 || (!ok && Nlinhas==5), "interrupcao da tabela paralela: " + nome);
+  }
+
+  // Entradas demais: as geracoes falham sem chamar o receptor
+  Circuito C40 = circuitoLargo(MAX_ENTRADAS_TABELA+1);
+  int chamadas = 0;
+  auto contar = [&](long long, const bool3S*, const bool3S*) { return ++chamadas<0; };
+  verificar(!C40.gerarTabela(contar) && !C40.gerarTabela(contar, OrdemTabela::GRAY) &&
+            !C40.gerarTabela(contar, P) && chamadas==0, "tabela com entradas demais");
+}
+
+/// ***********************
+/// Portas
+/// ***********************
+
+// Cria uma porta do tipo de indice t (na ordem de TIPOS) com Nin entradas
+static ptr_Porta criarPorta(int t, int Nin)
+{
+  switch (t)
+  {
+  case 0: return new PortaNOT();
+  case 1: return new PortaAND(Nin);
+  case 2: return new PortaNAND(Nin);
+  case 3: return new PortaOR(Nin);
+  case 4: return new PortaNOR(Nin);
+  case 5: return new PortaXOR(Nin);
+  default: return new PortaNXOR(Nin);
+  }
+}
+
+// Cada tipo de porta, com todas as combinacoes de ateh 4 entradas
+static void testarPortas()
+{
+  cout << "Portas" << endl;
+  for (int t=0; t<7; ++t)
+  {
+    for (int n=1; n<=4; ++n)
+    {
+      if ((t==0) != (n==1)) continue;
+      ptr_Porta P = criarPorta(t, n);
+      ptr_Porta copia = P->clone();
+      const string nome = string(TIPOS[t]) + " com " + to_string(n) + " entradas";
+      verificar(P->getName()==TIPOS[t] && nomePorta(P->getTipo())==TIPOS[t] &&
+                P->getTipo()==TipoPorta(t) && P->getNumInputs()==n &&
+                copia->getName()==TIPOS[t] && copia->getNumInputs()==n, "tipo: " + nome);
+
+      bool ok = true;
+      long long total = 1;
+      for (int k=0; k<n; ++k) total *= 3;
+      for (long long l=0; l<total && ok; ++l)
+      {
+        vector<bool3S> in = entradasDaLinha(l, n);
+        const bool3S esperado = avaliarReferencia(TIPOS[t], in);
+        ok = P->simular(in) && P->getOutput()==esperado && copia->simular(in) &&
+             copia->getOutput()==esperado && avaliarPorta(TipoPorta(t), in.data(), n)==esperado;
+      }
+      verificar(ok, "simular: " + nome);
+      verificar(!P->simular(vector<bool3S>(n+1, bool3S::TRUE)) && P->getOutput()==bool3S::UNDEF,
+                "simular com entradas demais: " + nome);
+      delete P;
+      delete copia;
+    }
+  }
+}
+
+/// ***********************
+/// Operadores bool3S
+/// ***********************
+
+// Os operadores comparados com a definicao da logica de Kleene: com a ordem
+// FALSE < UNDEF < TRUE, AND eh o minimo, OR eh o maximo e NOT inverte a ordem
+static void testarBool3S()
+{
+  cout << "Operadores bool3S" << endl;
+  auto ordem = [](bool3S x) { return (x==bool3S::FALSE ? 0 : (x==bool3S::UNDEF ? 1 : 2)); };
+  const bool3S porOrdem[3] = {bool3S::FALSE, bool3S::UNDEF, bool3S::TRUE};
+  bool ok = true;
+  for (int a=0; a<3; ++a)
+  {
+    const bool3S x = bool3S(a);
+    ok = ok && ~x==porOrdem[2-ordem(x)] && toBool3S(toChar(x))==x;
+    for (int b=0; b<3; ++b)
+    {
+      const bool3S y = bool3S(b);
+      const bool3S e = porOrdem[min(ordem(x), ordem(y))];
+      const bool3S ou = porOrdem[max(ordem(x), ordem(y))];
+      const bool3S xou = (x==bool3S::UNDEF || y==bool3S::UNDEF ? bool3S::UNDEF :
+                          (x!=y ? bool3S::TRUE : bool3S::FALSE));
+      bool3S z1 = x, z2 = x, z3 = x;
+      z1 &= y;
+      z2 |= y;
+      z3 ^= y;
+      ok = ok && (x&y)==e && (x|y)==ou && (x^y)==xou && z1==e && z2==ou && z3==xou;
+    }
+    // Incremento e decremento circulares: UNDEF -> FALSE -> TRUE -> UNDEF
+    bool3S z = x;
+    ok = ok && ++z==bool3S((a+1)%3) && --z==x && z++==x && z--==bool3S((a+1)%3) && z==x;
+  }
+  verificar(ok && sizeof(bool3S)==1, "operadores bool3S");
+}
+
+/// ***********************
+/// Arena de portas
+/// ***********************
+
+// A arena diretamente e os circuitos cujas portas estao nela, depois de varias
+// substituicoes de portas, redimensionamentos e copias
+static void testarArena(mt19937& G)
+{
+  cout << "Arena de portas" << endl;
+
+  // Cada tipo de porta em uma posicao; depois, outro tipo na mesma posicao
+  ArenaPortas A;
+  A.alocar(7);
+  bool ok = (A.size()==7);
+  vector<ptr_Porta> P(7);
+  for (int t=0; t<7; ++t) P[t] = A.criar(t, TipoPorta(t), (t==0 ? 1 : 3));
+  for (int t=0; t<7; ++t)
+  {
+    ok = ok && P[t]->getName()==TIPOS[t] && P[t]->getNumInputs()==(t==0 ? 1 : 3);
+    ArenaPortas::destruir(P[t]);
+    const int u = (t+3)%7;
+    P[t] = A.criar(t, TipoPorta(u), (u==0 ? 1 : 2));
+    ok = ok && P[t]->getName()==TIPOS[u] && P[t]->getNumInputs()==(u==0 ? 1 : 2);
+  }
+  for (ptr_Porta p : P) ArenaPortas::destruir(p);
+  A.liberar();
+  verificar(ok && A.size()==0, "ArenaPortas");
+
+  // Conexoes em vetores contiguos: aumentar e diminuir o numero de entradas de uma porta
+  // mantem as origens que jah existiam (as novas sao 0) e nao altera as demais portas
+  ConexoesPortas K(50);
+  vector< vector<int> > ref(50);
+  ok = true;
+  for (int k=0; k<2000 && ok; ++k)
+  {
+    const int i = int(G()%50), N = int(G()%6);
+    K.setNumInputs(i, N);
+    ref[i].resize(N, 0);
+    if (N>0)
+    {
+      const int j = int(G()%N), id = 1+int(G()%100);
+      K[i][j] = id;
+      ref[i][j] = id;
+    }
+    int total = 0;
+    for (int p=0; p<50 && ok; ++p)
+    {
+      ok = K.getNumInputs(p)==int(ref[p].size()) && equal(ref[p].begin(), ref[p].end(), K[p]);
+      total += int(ref[p].size());
+    }
+    ok = ok && K.getNumConexoes()==total;
+  }
+  ConexoesPortas copiaK(K);
+  for (int p=0; p<50 && ok; ++p)
+  {
+    ok = copiaK.getNumInputs(p)==int(ref[p].size()) && equal(ref[p].begin(), ref[p].end(), copiaK[p]);
+  }
+  vector<int> iniIn = {0, 2, 3}, idIn = {-1, 1, -2};
+  ConexoesPortas M(2);
+  M.atribuir(iniIn, idIn);
+  verificar(ok && M.getNumInputs(0)==2 && M.getNumInputs(1)==1 && M[0][1]==1 && M[1][0]==-2 &&
+            M.getNumConexoes()==3, "ConexoesPortas");
+
+  for (int caso=0; caso<30; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%6), NO = 1+int(G()%4), NP = 2+int(G()%30);
+    Descricao D = circuitoAleatorio(G, NI, NO, NP, comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    // Substitui algumas portas (a antiga eh destruida e a nova ocupa o mesmo slot)
+    for (int k=0; k<5; ++k)
+    {
+      const int p = int(G()%NP);
+      D.tipo[p] = TIPOS[G()%7];
+      const int Nin = (D.tipo[p]=="NT" ? 1 : 2+int(G()%3));
+      D.entradas[p].resize(Nin);
+      for (int& id : D.entradas[p])
+      {
+        const int r = int(G()%(NI + (comLacos ? NP : p)));
+        id = (r<NI ? -(r+1) : r-NI+1);
+      }
+      string tipo = D.tipo[p];
+      C.setPort(p+1, tipo, Nin);
+      for (int i=0; i<Nin; ++i) C.setIdInPort(p+1, i, D.entradas[p][i]);
+    }
+    vector<bool3S> in = entradasAleatorias(G, NI);
+    verificar(C.simular(in) && saidasCircuito(C)==simularReferencia(D, in), "portas substituidas: " + nome);
+
+    // Copia, atribuicao sobre um circuito com outras portas e redimensionamento
+    Circuito copia(C), outro = construir(circuitoAleatorio(G, 2, 1, 5, false));
+    outro = C;
+    Circuito menor(C);
+    menor.resize(NI, NO, NP/2);
+    verificar(copia==C && outro==C && menor.getNumPorts()==NP/2 &&
+              copia.simular(in) && saidasCircuito(copia)==simularReferencia(D, in) &&
+              outro.simular(in) && saidasCircuito(outro)==simularReferencia(D, in),
+              "copias na arena: " + nome);
+    C.clear();
+    verificar(C.getNumPorts()==0 && copia.simular(in), "clear: " + nome);
+  }
+}
+
+/// ***********************
+/// Copia sob escrita
+/// ***********************
+
+// Copias que compartilham a estrutura e a representacao compilada: simular ou alterar
+// uma delas nao pode afetar as outras
+static void testarCopiaSobEscrita(mt19937& G)
+{
+  cout << "Copia sob escrita" << endl;
+  for (int caso=0; caso<30; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%6), NO = 1+int(G()%4), NP = 1+int(G()%30);
+    Descricao D = circuitoAleatorio(G, NI, NO, NP, comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    // O original simula; as copias simulam outras entradas e as saidas dele nao mudam
+    const vector<bool3S> in = entradasAleatorias(G, NI);
+    C.simular(in);
+    const vector<bool3S> saidas = saidasCircuito(C);
+    vector<Circuito> copias(4, C);
+    bool ok = (saidas==simularReferencia(D, in));
+    for (Circuito& copia : copias)
+    {
+      vector<bool3S> outra = entradasAleatorias(G, NI);
+      ok = ok && copia.simular(outra) && saidasCircuito(copia)==simularReferencia(D, outra);
+      ok = ok && saidasCircuito(C)==saidas;
+    }
+    verificar(ok, "simulacao das copias: " + nome);
+
+    // Cada copia recebe uma alteracao diferente; as demais e o original nao mudam
+    vector<Descricao> descr(copias.size(), D);
+    for (size_t k=0; k<copias.size(); ++k)
+    {
+      const int j = int(G()%NO);
+      const int r = int(G()%(NI+NP));
+      descr[k].saidas[j] = (r<NI ? -(r+1) : r-NI+1);
+      copias[k].setIdOutputCirc(j+1, descr[k].saidas[j]);
+    }
+    ok = true;
+    for (size_t k=0; k<copias.size(); ++k)
+    {
+      vector<bool3S> outra = entradasAleatorias(G, NI);
+      ok = ok && copias[k].simular(outra) && saidasCircuito(copias[k])==simularReferencia(descr[k], outra);
+    }
+    verificar(ok && saidasCircuito(C)==saidas && C.simular(in) && saidasCircuito(C)==saidas,
+              "alteracao das copias: " + nome);
+  }
+
+  // Circuitos vazios
+  Circuito V1, V2(V1);
+  V2.resize(1, 1, 1);
+  verificar(V1.getNumInputs()==0 && V1.getNumPorts()==0 && V2.getNumPorts()==1, "circuitos vazios");
+}
+
+/// ***********************
+/// Simulacao sem alocacoes
+/// ***********************
+
+// Depois da primeira simulacao (que compila o circuito), as seguintes nao alocam memoria
+static void testarSemAlocacao(mt19937& G)
+{
+  cout << "Simulacao sem alocacoes" << endl;
+  for (int caso=0; caso<20; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NP = 1+int(G()%40);
+    Descricao D = circuitoAleatorio(G, NI, 1+int(G()%4), NP, comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    vector< vector<bool3S> > vetores;
+    for (int k=0; k<20; ++k) vetores.push_back(entradasAleatorias(G, NI));
+    const vector<bool3S_64> in64(NI, toBool3S_64(bool3S::TRUE));
+    const vector<bool3S_bloco> inBloco(NI, toBool3S_bloco(bool3S::FALSE));
+    C.simular(vetores[0]);
+    C.simularEventos(vetores[0]);
+    C.simular64(in64);
+    C.simularBloco(inBloco);
+
+    const long long antes = Nalocacoes;
+    for (const auto& in : vetores)
+    {
+      C.simular(in);
+      C.simularEventos(in);
+    }
+    C.simular64(in64);
+    C.simularBloco(inBloco);
+    const bool semAlocacoes = (Nalocacoes==antes);
+    verificar(semAlocacoes, "alocacoes na simulacao: " + nome);
+  }
+
+  // Porta::simular com ponteiro e numero de entradas
+  PortaNAND P(3);
+  const bool3S in[3] = {bool3S::TRUE, bool3S::TRUE, bool3S::UNDEF};
+  const long long antes = Nalocacoes;
+  const bool3S in2[3] = {bool3S::TRUE, bool3S::FALSE, bool3S::UNDEF};
+  bool ok = P.simular(in, 3) && P.getOutput()==bool3S::UNDEF && P.simular(in2, 3) &&
+            P.getOutput()==bool3S::TRUE;
+  ok = ok && !P.simular(in, 2) && P.getOutput()==bool3S::UNDEF && Nalocacoes==antes;
+  verificar(ok, "Porta::simular com ponteiro");
+}
+
+/// ***********************
+/// Validade
+/// ***********************
+
+// valid() acompanha todas as alteracoes do circuito, inclusive nas copias
+static void testarValidade(mt19937& G)
+{
+  cout << "Validade" << endl;
+  for (int caso=0; caso<20; ++caso)
+  {
+    const int NI = 1+int(G()%6), NO = 1+int(G()%4), NP = 2+int(G()%20);
+    Descricao D = circuitoAleatorio(G, NI, NO, NP, caso%2==1);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso);
+
+    // Uma porta trocada por outra com uma entrada a mais, ainda indefinida; uma copia
+    // feita nesse estado fica invalida, mesmo depois que o original eh completado
+    const int p = int(G()%NP), Nin = int(D.entradas[p].size())+1;
+    string tipo = "AN";
+    bool ok = C.valid() && C.setPort(p+1, tipo, Nin) && !C.valid();
+    Circuito copia(C);
+    ok = ok && C.setIdInPort(p+1, Nin-1, -1) && C.valid();
+    ok = ok && !copia.valid() && !copia.simular(entradasAleatorias(G, NI));
+    verificar(ok, "validade apos setPort e setIdInPort: " + nome);
+
+    // Redimensionar deixa as portas novas indefinidas; limpar deixa o circuito invalido
+    Circuito maior(C);
+    maior.resize(NI, NO, NP+1);
+    Circuito vazio(C);
+    vazio.clear();
+    verificar(C.valid() && !maior.valid() && !vazio.valid(), "validade apos resize e clear: " + nome);
+  }
+}
+
+/// ***********************
+/// Lacos combinacionais
+/// ***********************
+
+// Os lacos de uma descricao: as componentes fortemente conexas com realimentacao,
+// calculadas pelo fecho transitivo da relacao "a porta q depende da porta p"
+static vector< vector<int> > lacosReferencia(const Descricao& D)
+{
+  const int NP = int(D.tipo.size());
+  vector< vector<char> > alcanca(NP, vector<char>(NP, 0));
+  for (int q=0; q<NP; ++q)
+  {
+    for (int id : D.entradas[q]) if (id>0) alcanca[id-1][q] = 1;
+  }
+  for (int k=0; k<NP; ++k)
+  {
+    for (int p=0; p<NP; ++p)
+    {
+      if (!alcanca[p][k]) continue;
+      for (int q=0; q<NP; ++q) if (alcanca[k][q]) alcanca[p][q] = 1;
+    }
+  }
+  vector< vector<int> > lacos;
+  vector<char> usada(NP, 0);
+  for (int p=0; p<NP; ++p)
+  {
+    if (usada[p] || !alcanca[p][p]) continue;
+    vector<int> laco;
+    for (int q=p; q<NP; ++q)
+    {
+      if (alcanca[p][q] && alcanca[q][p])
+      {
+        laco.push_back(q+1);
+        usada[q] = 1;
+      }
+    }
+    lacos.push_back(laco);
+  }
+  return lacos;
+}
+
+// getLacos e a simulacao de circuitos com varios lacos, encadeados ou nao
+static void testarLacos(mt19937& G)
+{
+  cout << "Lacos combinacionais" << endl;
+  for (int caso=0; caso<60; ++caso)
+  {
+    const int NI = 1+int(G()%6), NO = 1+int(G()%5), NP = 1+int(G()%40);
+    Descricao D = circuitoAleatorio(G, NI, NO, NP, true);
+
+    // Nos casos pares, a maior parte das portas soh usa portas anteriores,
+    // para que os lacos sejam pequenos e separados por portas fora de lacos
+    if (caso%2==0)
+    {
+      for (int p=0; p<NP; ++p)
+      {
+        for (int& id : D.entradas[p])
+        {
+          if (id>p+1 && G()%4!=0) id = (p>0 ? 1+int(G()%p) : -1);
+        }
+      }
+    }
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso);
+
+    vector< vector<int> > lacos = C.getLacos(), esperados = lacosReferencia(D);
+    sort(lacos.begin(), lacos.end());
+    sort(esperados.begin(), esperados.end());
+    verificar(lacos==esperados && C.possuiCiclo()==!esperados.empty(), "getLacos: " + nome);
+
+    bool ok = true;
+    for (int k=0; k<20 && ok; ++k)
+    {
+      vector<bool3S> in = entradasAleatorias(G, NI);
+      vector<bool3S> esperado = simularReferencia(D, in);
+      ok = C.simular(in) && saidasCircuito(C)==esperado;
+      ok = ok && C.simularEventos(in) && saidasCircuito(C)==esperado;
+    }
+    verificar(ok, "simular com lacos: " + nome);
+  }
+}
+
+/// ***********************
+/// Cone de influencia
+/// ***********************
+
+// As entradas das quais dependem as saidas ids de uma descricao, em ordem (-1, -2, ...)
+static vector<int> coneReferencia(const Descricao& D, const vector<int>& ids)
+{
+  vector<char> visitada(D.tipo.size(), 0), entrada(D.NI, 0);
+  vector<int> pilha;
+  for (int j : ids) pilha.push_back(D.saidas[j-1]);
+  while (!pilha.empty())
+  {
+    const int id = pilha.back();
+    pilha.pop_back();
+    if (id<0) entrada[-id-1] = 1;
+    else if (!visitada[id-1])
+    {
+      visitada[id-1] = 1;
+      pilha.insert(pilha.end(), D.entradas[id-1].begin(), D.entradas[id-1].end());
+    }
+  }
+  vector<int> cone;
+  for (int i=0; i<D.NI; ++i) if (entrada[i]) cone.push_back(-(i+1));
+  return cone;
+}
+
+// simularSaidas, getEntradasCone e a tabela verdade de algumas saidas
+static void testarCone(mt19937& G)
+{
+  cout << "Cone de influencia" << endl;
+  for (int caso=0; caso<40; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NO = 1+int(G()%5);
+    Descricao D = circuitoAleatorio(G, NI, NO, 1+int(G()%30), comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    // Um subconjunto das saidas: as demais ficam UNDEF
+    vector<int> ids;
+    for (int j=1; j<=NO; ++j) if (G()%2==0) ids.push_back(j);
+    if (ids.empty()) ids.push_back(1+int(G()%NO));
+    const vector<int> cone = C.getEntradasCone(ids);
+    verificar(cone==coneReferencia(D, ids), "getEntradasCone: " + nome);
+
+    bool ok = true;
+    for (int k=0; k<10 && ok; ++k)
+    {
+      vector<bool3S> in = entradasAleatorias(G, NI);
+      vector<bool3S> esperado = simularReferencia(D, in);
+      ok = C.simularSaidas(ids, in);
+      for (int j=1; j<=NO; ++j)
+      {
+        bool pedida = (find(ids.begin(), ids.end(), j)!=ids.end());
+        ok = ok && C.getOutputCirc(j)==(pedida ? esperado[j-1] : bool3S::UNDEF);
+      }
+    }
+    verificar(ok, "simularSaidas: " + nome);
+
+    // Tabela do cone: as entradas fora do cone podem ter qualquer valor
+    long long Nlinhas = 0;
+    ok = C.gerarTabela(ids, [&](long long linha, const bool3S* in, const bool3S* out)
+    {
+      vector<bool3S> entradas = entradasAleatorias(G, NI);
+      for (size_t k=0; k<cone.size(); ++k) entradas[-cone[k]-1] = in[k];
+      vector<bool3S> esperado = simularReferencia(D, entradas);
+      bool linhaOK = (linha==Nlinhas++);
+      for (size_t k=0; k<ids.size(); ++k) linhaOK = linhaOK && out[k]==esperado[ids[k]-1];
+      return linhaOK;
+    });
+    verificar(ok && Nlinhas==numLinhasTabela(int(cone.size())), "gerarTabela do cone: " + nome);
+    verificar(!C.simularSaidas(vector<int>(1, NO+1), entradasAleatorias(G, NI)) &&
+              C.getEntradasCone(vector<int>(1, 0)).empty(), "cone com id invalida: " + nome);
+  }
+
+  // O limite de entradas vale para o cone: com 45 entradas, uma saida que soh depende
+  // de 3 delas tem tabela; uma que depende de todas, nao
+  Descricao L;
+  L.NI = MAX_ENTRADAS_TABELA+6;
+  L.tipo = {"AN", "OR"};
+  L.entradas.resize(2);
+  for (int i=0; i<L.NI; ++i) L.entradas[0].push_back(-(i+1));
+  L.entradas[1] = {-1, -2, -3};
+  L.saidas = {1, 2};
+  Circuito C = construir(L);
+  long long Nlinhas = 0;
+  auto contar = [&](long long, const bool3S*, const bool3S*) { ++Nlinhas; return true; };
+  verificar(C.gerarTabela(vector<int>(1, 2), contar) && Nlinhas==27 &&
+            !C.gerarTabela(vector<int>(1, 1), contar) && Nlinhas==27, "tabela de um cone pequeno");
+}
+
+/// ***********************
+/// Tabela verdade binaria
+/// ***********************
+
+// A tabela binaria (apenas entradas FALSE e TRUE, na ordem da base 2) comparada com a
+// referencia, com e sem lacos (simulacao ternaria e binaria)
+static void testarTabelaBinaria(mt19937& G)
+{
+  cout << "Tabela verdade binaria" << endl;
+  for (int caso=0; caso<30; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NO = 1+int(G()%4);
+    Descricao D = circuitoAleatorio(G, NI, NO, 1+int(G()%30), comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    long long Nlinhas = 0;
+    bool ok = C.gerarTabelaBinaria([&](long long linha, const bool3S* in, const bool3S* out)
+    {
+      vector<bool3S> entradas(NI);
+      for (int i=0; i<NI; ++i)
+      {
+        entradas[i] = (((linha >> (NI-1-i)) & 1) ? bool3S::TRUE : bool3S::FALSE);
+      }
+      return linha==Nlinhas++ && vector<bool3S>(in, in+NI)==entradas &&
+             vector<bool3S>(out, out+NO)==simularReferencia(D, entradas);
+    });
+    verificar(ok && Nlinhas==numLinhasTabelaBinaria(NI), "gerarTabelaBinaria: " + nome);
+
+    // Interrupcao pelo receptor
+    Nlinhas = 0;
+    ok = C.gerarTabelaBinaria([&](long long, const bool3S*, const bool3S*) { return ++Nlinhas<3; });
+    verificar(NI<2 || (!ok && Nlinhas==3), "interrupcao da tabela binaria: " + nome);
+  }
+
+  // Limites: 2^62 linhas cabem em um long long; 2^63 nao
+  verificar(numLinhasTabelaBinaria(MAX_ENTRADAS_BINARIA)==(1LL<<62) &&
+            numLinhasTabelaBinaria(MAX_ENTRADAS_BINARIA+1)<0 && numLinhasTabelaBinaria(-1)<0,
+            "numLinhasTabelaBinaria no limite");
+  Circuito C63 = circuitoLargo(MAX_ENTRADAS_BINARIA+1);
+  int chamadas = 0;
+  auto contar = [&](long long, const bool3S*, const bool3S*) { return ++chamadas<0; };
+  verificar(!C63.gerarTabelaBinaria(contar) && chamadas==0, "tabela binaria com entradas demais");
+}
+
+/// ***********************
+/// Dominios de valores
+/// ***********************
+
+// A versao const e generica de CircuitoCompilado::simular, instanciada para cada dominio
+// de valores, comparada com a referencia (os dominios binarios soh sem lacos)
+static void testarDominios(mt19937& G)
+{
+  cout << "Dominios de valores" << endl;
+  for (int caso=0; caso<40; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%8), NO = 1+int(G()%5);
+    Descricao D = circuitoAleatorio(G, NI, NO, 1+int(G()%40), comLacos);
+    Circuito C = construir(D);
+    const CircuitoCompilado& CC = C.getCompilado();
+    const int NS = CC.getNumSinais();
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    // Um vetor de entrada diferente em cada posicao dos dominios vetoriais
+    vector< vector<bool3S> > vetores(BOOL3S_BLOCO);
+    vector< vector<bool3S> > esperados(BOOL3S_BLOCO);
+    vector<bool3S_64> in64(NI, toBool3S_64(bool3S::UNDEF));
+    vector<bool3S_bloco> inBloco(NI, toBool3S_bloco(bool3S::UNDEF));
+    for (int l=0; l<BOOL3S_BLOCO; ++l)
+    {
+      vetores[l] = entradasAleatorias(G, NI);
+      esperados[l] = simularReferencia(D, vetores[l]);
+      for (int i=0; i<NI; ++i)
+      {
+        if (l<64) setBool3S(in64[i], l, vetores[l][i]);
+        setBool3S(inBloco[i], l, vetores[l][i]);
+      }
+    }
+
+    vector<bool3S> V(NS);
+    vector<bool3S_64> V64(NS);
+    vector<bool3S_bloco> VBloco(NS);
+    CC.simular(vetores[0].data(), V.data());
+    CC.simular(in64.data(), V64.data());
+    CC.simular(inBloco.data(), VBloco.data());
+    bool ok = true;
+    for (int j=0; j<NO; ++j)
+    {
+      const int s = CC.sinal(D.saidas[j]);
+      ok = ok && V[s]==esperados[0][j];
+      for (int l=0; l<BOOL3S_BLOCO; ++l)
+      {
+        ok = ok && (l>=64 || getBool3S(V64[s], l)==esperados[l][j]) &&
+             getBool3S(VBloco[s], l)==esperados[l][j];
+      }
+    }
+    verificar(ok, "simular ternario: " + nome);
+    if (comLacos) continue;
+
+    // Dominios binarios: apenas entradas FALSE e TRUE (bool sem vector<bool>, que nao
+    // eh contiguo)
+    vector<uint64_t> inBin(NI, 0);
+    vector< vector<bool3S> > binarios(64, vector<bool3S>(NI));
+    for (int l=0; l<64; ++l)
+    {
+      for (int i=0; i<NI; ++i)
+      {
+        const bool b = (G()%2==1);
+        binarios[l][i] = (b ? bool3S::TRUE : bool3S::FALSE);
+        if (b) inBin[i] |= (uint64_t(1) << l);
+      }
+    }
+    unique_ptr<bool[]> in1(new bool[NI]), V1(new bool[NS]);
+    for (int i=0; i<NI; ++i) in1[i] = (binarios[0][i]==bool3S::TRUE);
+    vector<uint64_t> VBin(NS);
+    CC.simular(in1.get(), V1.get());
+    CC.simular(inBin.data(), VBin.data());
+    for (int l=0; l<64 && ok; ++l)
+    {
+      vector<bool3S> esperado = simularReferencia(D, binarios[l]);
+      for (int j=0; j<NO; ++j)
+      {
+        const int s = CC.sinal(D.saidas[j]);
+        const bool3S b = (((VBin[s] >> l) & 1) ? bool3S::TRUE : bool3S::FALSE);
+        ok = ok && b==esperado[j] &&
+             (l>0 || (V1[s] ? bool3S::TRUE : bool3S::FALSE)==esperado[j]);
+      }
+    }
+    verificar(ok, "simular binario: " + nome);
+  }
+}
+
+/// ***********************
+/// Otimizacoes
+/// ***********************
+
+// O hash estrutural tem que preservar todas as saidas e eliminar as duplicatas
+static void testarOtimizacoes(mt19937& G)
+{
+  cout << "Otimizacoes" << endl;
+  for (int caso=0; caso<40; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%5), NO = 1+int(G()%4), NP = 2+int(G()%40);
+    Descricao D = circuitoAleatorio(G, NI, NO, NP, comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    ResultadoOtimizacao R;
+    verificar(hashEstrutural(C, R) && R.NportasAntes==NP && R.NportasDepois<=R.NportasAntes &&
+              R.NportasDepois==R.circ.getNumPorts() && int(R.mapa.size())==NP &&
+              tabelaIgualReferencia(R.circ, D), "hashEstrutural: " + nome);
+
+    R = ResultadoOtimizacao();
+    verificar(simplificar(C, R) && R.NportasDepois<=R.NportasAntes &&
+              tabelaIgualReferencia(R.circ, D), "simplificar: " + nome);
+
+    // Com uma entrada fixada, as saidas soh precisam ser iguais quando ela tem o valor fixado
+    const int fixa = -1-int(G()%NI);
+    const bool3S valor = bool3S(G()%3);
+    R = ResultadoOtimizacao();
+    bool ok = simplificar(C, vector<int>(1, fixa), vector<bool3S>(1, valor), R);
+    ok = ok && R.circ.getNumInputs()==NI &&
+         R.circ.gerarTabela([&](long long, const bool3S* in, const bool3S* out)
+    {
+      if (in[-fixa-1]!=valor) return true;
+      vector<bool3S> esperado = simularReferencia(D, vector<bool3S>(in, in+NI));
+      return equal(esperado.begin(), esperado.end(), out);
+    });
+    verificar(ok, "simplificar com entrada fixada: " + nome);
+    verificar(!simplificar(C, vector<int>(1, -NI-1), vector<bool3S>(1, valor), R) &&
+              !simplificar(C, vector<int>(1, fixa), vector<bool3S>(), R),
+              "simplificar com entrada fixada invalida: " + nome);
+  }
+
+  // Duplicatas em cascata, com as entradas em outra ordem: restam 2 das 4 portas
+  Descricao D;
+  D.NI = 2;
+  D.tipo = {"AN", "AN", "NT", "NT"};
+  D.entradas = {{-1, -2}, {-2, -1}, {1}, {2}};
+  D.saidas = {3, 4};
+  Circuito C = construir(D);
+  ResultadoOtimizacao R;
+  verificar(hashEstrutural(C, R) && R.NportasDepois==2 && R.mapa[1]==R.mapa[0] &&
+            R.mapa[3]==R.mapa[2] && tabelaIgualReferencia(R.circ, D), "hashEstrutural em cascata");
+  verificar(!hashEstrutural(Circuito(), R) && R.NportasDepois==2, "hashEstrutural de circuito invalido");
+}
+
+/// ***********************
+/// Simplificacao
+/// ***********************
+
+// Propagacao de constantes, buffers e portas inuteis em um circuito conhecido
+static void testarSimplificacao()
+{
+  cout << "Simplificacao" << endl;
+
+  // S1 = a OR b; S2 = (a OR b) AND b, com uma porta que nao influencia as saidas.
+  // Com a=TRUE, S1 eh TRUE e S2 eh igual a b: soh resta uma porta
+  Descricao D;
+  D.NI = 2;
+  D.tipo = {"OR", "AN", "XO"};
+  D.entradas = {{-1, -2}, {1, -2}, {-1, -2}};
+  D.saidas = {1, 2};
+  Circuito C = construir(D);
+  ResultadoOtimizacao R;
+  verificar(simplificar(C, R) && R.NportasDepois==2 && R.mapa[2]==0 &&
+            tabelaIgualReferencia(R.circ, D), "simplificar sem entradas fixadas");
+  bool ok = simplificar(C, vector<int>(1, -1), vector<bool3S>(1, bool3S::TRUE), R) &&
+            R.NportasDepois<=1;
+  for (int b=0; b<3 && ok; ++b)
+  {
+    vector<bool3S> in = {bool3S::TRUE, bool3S(b)};
+    ok = R.circ.simular(in) && saidasCircuito(R.circ)==simularReferencia(D, in);
+  }
+  verificar(ok, "simplificar com a=TRUE");
+}
+
+/// ***********************
+/// Arquivos do aplicativo
+/// ***********************
+
+// Gravacao e leitura (texto e binario), inclusive de arquivos corrompidos
+static void testarArquivos(mt19937& G)
+{
+  cout << "Arquivos" << endl;
+  const string arqTexto = "teste3_tmp.txt";
+  for (int caso=0; caso<20; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    Descricao D = circuitoAleatorio(G, 1+int(G()%6), 1+int(G()%4), 1+int(G()%50), comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    // ler e lerRapido leem o que salvar gravou
+    Circuito L1, L2;
+    verificar(C.salvar(arqTexto) && L1.ler(arqTexto) && L1==C, "salvar/ler: " + nome);
+    verificar(L2.lerRapido(arqTexto) && L2==C && tabelaIgualReferencia(L2, D),
+              "salvar/lerRapido: " + nome);
+
+    // Truncado ou com um caractere nulo: erro com a posicao, sem alterar o circuito
+    const string texto = lerArquivo(arqTexto);
+    ErroLeitura erro;
+    gravarArquivo(arqTexto, texto.substr(0, texto.size()/2));
+    verificar(!L2.lerRapido(arqTexto, &erro) && erro.linha>0 && L2==C, "texto truncado: " + nome);
+    verificar(!L1.ler(arqTexto) && L1==C, "texto truncado (ler): " + nome);
+    string comNulo = texto;
+    comNulo[texto.size()/2] = '\0';
+    gravarArquivo(arqTexto, comNulo);
+    verificar(!L2.lerRapido(arqTexto, &erro) && L2==C, "texto com caractere nulo: " + nome);
+  }
+
+  // Formato binario: o circuito lido simula como o original; um arquivo truncado ou com
+  // um byte alterado (soma de verificacao) eh rejeitado sem alterar o circuito
+  const string arqBinario = "teste3_tmp.bin";
+  for (int caso=0; caso<20; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    Descricao D = circuitoAleatorio(G, 1+int(G()%6), 1+int(G()%4), 1+int(G()%50), comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    Circuito B;
+    verificar(C.salvarBinario(arqBinario) && B.lerBinario(arqBinario) && B==C &&
+              tabelaIgualReferencia(B, D), "salvarBinario/lerBinario: " + nome);
+    CircuitoCompilado CC;
+    bool ok = CC.lerBinario(arqBinario) && CC.getNumPorts()==C.getNumPorts();
+    for (int k=0; k<10 && ok; ++k)
+    {
+      vector<bool3S> in = entradasAleatorias(G, D.NI), V(CC.getNumSinais());
+      vector<bool3S> esperado = simularReferencia(D, in);
+      CC.simular(in.data(), V.data());
+      for (int j=0; j<int(D.saidas.size()); ++j) ok = ok && CC.getOutputCirc(j, V.data())==esperado[j];
+    }
+    verificar(ok, "CircuitoCompilado::lerBinario: " + nome);
+
+    const string binario = lerArquivo(arqBinario);
+    gravarArquivo(arqBinario, binario.substr(0, binario.size()-64));
+    verificar(!B.lerBinario(arqBinario) && B==C, "binario truncado: " + nome);
+    string alterado = binario;
+    alterado[64+G()%(binario.size()-64)] ^= 0x10;
+    gravarArquivo(arqBinario, alterado);
+    verificar(!B.lerBinario(arqBinario) && B==C && !CC.lerBinario(arqBinario) &&
+              CC.getNumPorts()==C.getNumPorts(), "binario alterado: " + nome);
+  }
+
+  // Estrutura corrompida com a soma de verificacao correta. No circuito abaixo, as portas
+  // 1, 2 e 3 formam um laco (posicoes 0 a 2 da ordem), seguido pelas portas 4 e 5:
+  // os niveis sao 1, 1, 1, 2 e 3.
+  {
+    Descricao D;
+    D.NI = 2;
+    D.tipo = {"AN", "OR", "NT", "XO", "NT"};
+    D.entradas = {{-1, 3}, {1, -2}, {2}, {3, -1}, {4}};
+    D.saidas = {5};
+    Circuito C = construir(D);
+    CircuitoCompilado CC;
+    string binario;
+    bool ok = C.salvarBinario(arqBinario) && CC.lerBinario(arqBinario);
+    if (ok)
+    {
+      binario = lerArquivo(arqBinario);
+      ok = (CC.getNumLacos()==1 && elementoBinario(binario, 9, CC.getOrdem()[4])==3);
+    }
+    verificar(ok, "binario de um circuito com laco");
+
+    // Cada alteracao: secao (na ordem das secoes do arquivo), elemento e novo valor
+    struct Alteracao { int secao, j, valor; string nome; };
+    const int ordem0 = (ok ? elementoBinario(binario, 6, 0) : 0);
+    const int ordem3 = (ok ? elementoBinario(binario, 6, 3) : 0);
+    const int ordem4 = (ok ? elementoBinario(binario, 6, 4) : 0);
+    const int fanout0 = (ok ? elementoBinario(binario, 5, 0) : 0);
+    const vector<Alteracao> alteracoes =
+    {
+      {6, 0, ordem0, "nenhuma alteracao"},
+      {6, 3, ordem4, "ordem fora da ordem topologica"},
+      {6, 4, ordem3, "ordem que nao eh uma permutacao"},
+      {9, ordem4, 2, "nivel errado"},
+      {5, 0, (fanout0+1)%5, "fanout diferente das conexoes"},
+      {8, 0, 4, "laco que nao eh fortemente conexo"},
+      {7, 0, 1, "porta fora do laco que recebe sinal de porta posterior"}
+    };
+    for (const Alteracao& A : alteracoes)
+    {
+      if (!ok) break;
+      string alterado = binario;
+      alterarBinario(alterado, A.secao, A.j, A.valor);
+      gravarArquivo(arqBinario, alterado);
+      Circuito B = C;
+      CircuitoCompilado CA = CC;
+      bool aceito = (A.nome=="nenhuma alteracao");
+      verificar(B.lerBinario(arqBinario)==aceito && B==C && CA.lerBinario(arqBinario)==aceito &&
+                CA.getNumPorts()==5, "binario com a estrutura alterada: " + A.nome);
+    }
+  }
+
+  Circuito B;
+  verificar(!B.lerBinario(arqTexto) && !B.lerBinario("teste3_inexistente.bin"),
+            "lerBinario de um arquivo que nao eh binario");
+  remove(arqBinario.c_str());
+
+  Circuito L;
+  ErroLeitura erro;
+  verificar(!L.lerRapido("teste3_inexistente.txt", &erro) && erro.linha==0 && !erro.mensagem.empty(),
+            "arquivo inexistente");
+  remove(arqTexto.c_str());
+}
+
+/// ***********************
+/// Importacao de netlists
+/// ***********************
+
+// Confere um circuito importado com y = NAND(a,b) e z = XOR(y,c) e, se houver
+// constantes, w = 1 (com a entrada das constantes em TRUE)
+static bool conferirImportado(Circuito& C, const NomesCircuito& N, bool comConstante)
+{
+  if (N.entradas.size()<3 || N.saidas.size()<2) return false;
+  const int a = N.idOrig("a"), b = N.idOrig("b"), c = N.idOrig("c");
+  if (a>=0 || b>=0 || c>=0) return false;
+  if (comConstante && N.entradaConstante>=0) return false;
+  bool ok = true;
+  C.gerarTabela([&](long long, const bool3S* in, const bool3S* out)
+  {
+    if (comConstante && in[-N.entradaConstante-1]!=bool3S::TRUE) return true;
+    bool3S y = ~(in[-a-1] & in[-b-1]);
+    bool3S z = y ^ in[-c-1];
+    ok = ok && out[0]==y && out[1]==z && (!comConstante || out[2]==bool3S::TRUE);
+    return ok;
+  });
+  return ok;
+}
+
+// Os formatos de netlist, inclusive arquivos invalidos
+static void testarImportacao()
+{
+  cout << "Importacao" << endl;
+  const string bench = "teste3_tmp.bench", blif = "teste3_tmp.blif", verilog = "teste3_tmp.v";
+  Circuito C;
+  NomesCircuito N;
+  ErroLeitura erro;
+  bool ok;
+
+  gravarArquivo(bench,
+    "# teste\n"
+    "INPUT(a)\nINPUT(b)\nINPUT(c)\n"
+    "OUTPUT(y)\nOUTPUT(z)\n"
+    "y = NAND(a, b)\n"
+    "z = XOR(y, c)\n");
+  ok = importarBench(bench, C, &N, &erro);
+  verificar(ok && conferirImportado(C, N, false) && N.entradaConstante==0, "bench: " + erro.texto());
+
+  gravarArquivo(blif,
+    ".model teste\n"
+    ".inputs a b c\n"
+    ".outputs y z w\n"
+    ".names a b y\n11 0\n"
+    ".names y c z\n10 1\n01 1\n"
+    ".names w\n1\n"
+    ".end\n");
+  ok = importarBlif(blif, C, &N, &erro);
+  verificar(ok && conferirImportado(C, N, true), "blif: " + erro.texto());
+
+  gravarArquivo(verilog,
+    "module teste(a, b, c, y, z, w);\n"
+    "  input a, b, c;\n"
+    "  output y, z, w;\n"
+    "  nand g1(y, a, b);\n"
+    "  xor (z, y, c);\n"
+    "  assign w = 1'b1;\n"
+    "endmodule\n");
+  ok = importarNetlist(verilog, C, &N, &erro);
+  verificar(ok && conferirImportado(C, N, true) && N.entradaConstante==-4 &&
+            N.entradas[3]==NOME_CONSTANTE, "verilog: " + erro.texto());
+
+  // Com a entrada das constantes fixada em TRUE, simplificar elimina as portas constantes
+  // e a saida constante vem diretamente dessa entrada
+  ResultadoOtimizacao R;
+  ok = simplificar(C, vector<int>(1, N.entradaConstante), vector<bool3S>(1, bool3S::TRUE), R);
+  verificar(ok && R.NportasDepois<R.NportasAntes &&
+            R.circ.getIdOutputCirc(3)==N.entradaConstante && conferirImportado(R.circ, N, true),
+            "constante simplificada");
+
+  // Flip-flops cortados: a saida vira entrada e a entrada vira saida, depois da
+  // entrada das constantes
+  gravarArquivo(blif, ".model t\n.inputs a\n.outputs y\n.latch d q 0\n.names a q d\n11 1\n"
+                      ".names y\n0\n.end\n");
+  ok = importarNetlist(blif, C, &N, &erro);
+  verificar(ok && N.Nflipflops==1 && N.entradaConstante==-2 && N.idOrig("q")==-3,
+            "blif com latch e constante: " + erro.texto());
+  gravarArquivo(bench, "INPUT(a)\nOUTPUT(q)\nq = DFF(d)\nd = NOT(a)\n");
+  ok = importarBench(bench, C, &N, &erro);
+  verificar(ok && N.Nflipflops==1 && C.getNumInputs()==2 && C.getNumOutputs()==2,
+            "bench com DFF: " + erro.texto());
+
+  // Arquivos invalidos: falham com uma mensagem e nao alteram o circuito
+  const Circuito anterior = C;
+  auto invalido = [&](const string& arq, const string& texto, const string& nome)
+  {
+    gravarArquivo(arq, texto);
+    erro = ErroLeitura();
+    verificar(!importarNetlist(arq, C, &N, &erro) && !erro.mensagem.empty() && C==anterior,
+              "deveria rejeitar " + nome);
+  };
+  invalido(bench, "INPUT(a)\nOUTPUT(y)\ny = AND(a, q)\n", "bench com sinal indefinido");
+  invalido(bench, string("INPUT(a)\nOUTPUT(y)\ny = NOT(a)\n") + '\0' + "\n", "bench com caractere nulo");
+  invalido(bench, "INPUT(a)\nOUTPUT(y)\ny = NOT(", "bench truncado");
+  invalido(bench, "INPUT(a)\nOUTPUT(y)\ny = FOO(a, a)\n", "bench com porta desconhecida");
+  invalido(blif, ".model t\n.inputs a\n.outputs y\n.names a y\nx 1\n.end\n",
+           "blif com literal invalido");
+  invalido(blif, string(".model t\n.inputs a") + '\0' + "\n.outputs y\n.names a y\n1 1\n.end\n",
+           "blif com caractere nulo");
+  invalido(blif, string(".model t\n.inputs a\n.outputs y\n.names a y\n") + '\0' + "1 1\n.end\n",
+           "blif com caractere nulo no inicio da linha");
+  invalido(blif, ".model t\n.inputs a b\n.outputs y\n.names a b y\n1 1\n.end\n",
+           "blif com cobertura de tamanho errado");
+  invalido(verilog, "module t(a, y);\n  input a;\n  output y;\n  assign y = ~a;\n",
+           "verilog sem endmodule");
+  invalido(verilog, "module t(a, y);\n  input a;\n  output y;\n  and (y, a, q);\nendmodule\n",
+           "verilog com sinal indefinido");
+  invalido(verilog, "module t(a, y);\n  input a;\n  output y;\n  assign y = a & a;\nendmodule\n",
+           "verilog com expressao");
+  verificar(!importarNetlist("teste3_inexistente.bench", C, &N, &erro) && C==anterior,
+            "deveria rejeitar arquivo inexistente");
+
+  remove(bench.c_str());
+  remove(blif.c_str());
+  remove(verilog.c_str());
+}
+
+/// ***********************
+/// Exportacao da tabela verdade
+/// ***********************
+
+// A tabela gravada em arquivo, nos dois formatos, com a ternaria e a binaria
+static void testarExportacao(mt19937& G)
+{
+  cout << "Exportacao" << endl;
+  const string arq = "teste3_tmp.tab", csv = "teste3_tmp.csv";
+  PoolTrabalho P(2);
+
+  // Formato binario: cabecalho e valores empacotados iguais aos da referencia
+  for (int caso=0; caso<10; ++caso)
+  {
+    const bool comLacos = (caso%2==1);
+    const int NI = 1+int(G()%5), NO = 1+int(G()%5);
+    Descricao D = circuitoAleatorio(G, NI, NO, 1+int(G()%30), comLacos);
+    Circuito C = construir(D);
+    const string nome = "caso " + to_string(caso) + (comLacos ? " (com lacos)" : "");
+
+    for (int binaria=0; binaria<2; ++binaria)
+    {
+      bool ok = exportarTabela(C, arq, FormatoTabela::BINARIO, binaria==1, &P);
+      const string dados = lerArquivo(arq);
+      const long long total = (binaria ? numLinhasTabelaBinaria(NI) : numLinhasTabela(NI));
+      CabecalhoTabela cab;
+      ok = ok && dados.size()==size_t(TAM_CABECALHO_TABELA + (total*NO+3)/4);
+      if (ok)
+      {
+        copy(dados.begin(), dados.begin()+sizeof(cab), reinterpret_cast<char*>(&cab));
+        ok = cab.NI==NI && cab.NO==NO && int(cab.binaria)==binaria && (long long)cab.Nlinhas==total;
+      }
+      for (long long l=0; l<total && ok; ++l)
+      {
+        vector<bool3S> in = entradasDaLinha(l, NI);
+        if (binaria)
+        {
+          for (int i=0; i<NI; ++i) in[i] = (((l >> (NI-1-i)) & 1) ? bool3S::TRUE : bool3S::FALSE);
+        }
+        vector<bool3S> esperado = simularReferencia(D, in);
+        for (int j=0; j<NO; ++j)
+        {
+          long long k = l*NO+j;
+          unsigned char byte = (unsigned char)dados[size_t(TAM_CABECALHO_TABELA + k/4)];
+          ok = ok && bool3S((byte >> (2*(k%4))) & 3)==esperado[j];
+        }
+      }
+      verificar(ok, string(binaria ? "exportarTabela binaria: " : "exportarTabela: ") + nome);
+    }
+
+    // CSV: uma linha de nomes e uma linha por combinacao
+    bool ok = exportarTabela(C, csv, FormatoTabela::CSV);
+    const string texto = lerArquivo(csv);
+    verificar(ok && count(texto.begin(), texto.end(), '\n')==numLinhasTabela(NI)+1 &&
+              formatoPorExtensao(csv)==FormatoTabela::CSV &&
+              formatoPorExtensao(arq)==FormatoTabela::BINARIO, "exportarTabela CSV: " + nome);
+  }
+
+  // Netlist com uma constante (y = a, z = 1): a entrada das constantes fica TRUE e nao
+  // aparece na tabela, que tem as 3 linhas (2 na binaria) da entrada a, e nao 9 (ou 4)
+  {
+    const string blif = "teste3_tmp.blif";
+    gravarArquivo(blif, ".model t\n.inputs a\n.outputs y z\n.names a y\n1 1\n.names z\n1\n.end\n");
+    Circuito B;
+    NomesCircuito nomes;
+    bool ok = importarBlif(blif, B, &nomes) && B.getNumInputs()==2 && nomes.entradaConstante==-2 &&
+              exportarTabela(B, csv, FormatoTabela::CSV, false, nullptr, &nomes);
+    verificar(ok && lerArquivo(csv)=="a,y,z\n?,?,T\nF,F,T\nT,T,T\n", "exportacao CSV com constante");
+    for (int binaria=0; binaria<2; ++binaria)
+    {
+      ok = exportarTabela(B, arq, FormatoTabela::BINARIO, binaria==1, &P, &nomes);
+      const string dados = lerArquivo(arq);
+      // Os valores (y, z) de cada linha, 2 bits cada, com z=TRUE
+      const vector<int> esperado = (binaria ? vector<int>{0xA9} : vector<int>{0x98, 0x0A});
+      CabecalhoTabela cab;
+      ok = ok && dados.size()==TAM_CABECALHO_TABELA+esperado.size();
+      if (ok)
+      {
+        copy(dados.begin(), dados.begin()+sizeof(cab), reinterpret_cast<char*>(&cab));
+        ok = cab.NI==1 && cab.NO==2 && (long long)cab.Nlinhas==(binaria ? 2 : 3);
+      }
+      for (size_t k=0; k<esperado.size() && ok; ++k)
+      {
+        ok = (unsigned char)dados[TAM_CABECALHO_TABELA+k]==esperado[k];
+      }
+      verificar(ok, string(binaria ? "exportacao binaria com constante" : "exportacao com constante"));
+    }
+    // Sem a tabela de nomes, a entrada das constantes eh uma entrada como as demais
+    ok = exportarTabela(B, csv, FormatoTabela::CSV);
+    const string texto = lerArquivo(csv);
+    verificar(ok && count(texto.begin(), texto.end(), '\n')==9+1, "exportacao sem a tabela de nomes");
+    remove(blif.c_str());
+  }
+
+  // Cancelamento pelo acompanhamento: o arquivo incompleto eh apagado
+  Descricao D = circuitoAleatorio(G, 12, 2, 20, false);
+  Circuito C = construir(D);
+  int chamadas = 0;
+  bool ok = exportarTabela(C, arq, FormatoTabela::BINARIO, false, &P, nullptr,
+                           [&](long long, long long) { return ++chamadas<2; });
+  verificar(!ok && chamadas==2 && !existeArquivo(arq), "cancelamento da exportacao");
+
+  // Circuitos com entradas demais: a exportacao falha sem criar o arquivo
+  Circuito C40 = circuitoLargo(MAX_ENTRADAS_TABELA+1);
+  verificar(!exportarTabela(C40, arq, FormatoTabela::BINARIO, false, &P) && !existeArquivo(arq) &&
+            !exportarTabela(C40, arq, FormatoTabela::CSV) && !existeArquivo(arq),
+            "exportacao com entradas demais");
+  Circuito C63 = circuitoLargo(MAX_ENTRADAS_BINARIA+1);
+  verificar(!exportarTabela(C63, arq, FormatoTabela::BINARIO, true) && !existeArquivo(arq),
+            "exportacao binaria com entradas demais");
+
+  // O modo em lote escolhe a leitura do circuito pela identificacao do formato binario
+  const string arqTexto = "teste3_tmp.txt", arqBinario = "teste3_tmp.bin";
+  verificar(C.salvar(arqTexto) && C.salvarBinario(arqBinario) &&
+            CircuitoCompilado::ehBinario(arqBinario) && !CircuitoCompilado::ehBinario(arqTexto) &&
+            !CircuitoCompilado::ehBinario("teste3_inexistente.bin"), "ehBinario");
+
+  remove(arq.c_str());
+  remove(csv.c_str());
+  remove(arqTexto.c_str());
+  remove(arqBinario.c_str());
+}
+
+int main(void)
+{
+  // Semente fixa: os circuitos sao os mesmos em todas as execucoes
+  mt19937 G(20171017);
+
+  testarSimulacao(G);
+  testarCompilado(G);
+  testarSimular64(G);
+  testarKernels(G);
+  testarEventos(G);
+  testarGray();
+  testarParalela(G);
+  testarTabela(G);
+  testarPortas();
+  testarBool3S();
+  testarArena(G);
+  testarCopiaSobEscrita(G);
+  testarSemAlocacao(G);
+  testarValidade(G);
+  testarLacos(G);
+  testarCone(G);
+  testarTabelaBinaria(G);
+  testarDominios(G);
+  testarOtimizacoes(G);
+  testarSimplificacao();
+  testarArquivos(G);
+  testarImportacao();
+  testarExportacao(G);
+
+  if (falhas==0) cout << "Todos os testes passaram" << endl;
+  else cout << falhas << " teste(s) falharam" << endl;
+  return (falhas==0 ? 0 : 1);
+}